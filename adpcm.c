@@ -0,0 +1,187 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+
+#ifdef OUTPUT_SINK
+
+#include "adpcm.h"        // For encoder structure
+
+/* Quantizer step sizes */
+static const int16_t step_table[89] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+	34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+	157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+	724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+	3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/* Step index change of each code (magnitude bits only) */
+static const int8_t index_table[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+/* Clamp a value to 16 bits signed */
+static inline int16_t clamp_s16(int32_t value) {
+	if (value > 32767) return 32767;
+	if (value < -32768) return -32768;
+	return value;
+}
+
+/* Clamp a step index */
+static inline uint8_t clamp_index(int16_t index) {
+	if (index < 0) return 0;
+	if (index > 88) return 88;
+	return index;
+}
+
+/* Quantize the difference with the predictor to a 4 bits code, update predictor and step index like the decoder */
+static inline uint8_t encode_sample(Adpcm_encoder_t *encoder, int16_t sample) {
+	int32_t step = step_table[encoder->index];
+	int32_t difference = (int32_t)sample - encoder->predictor;
+	uint8_t code = 0;
+	if (difference < 0) {
+		code = 8;
+		difference = -difference;
+	}
+
+	/* Successive approximation of difference / step (3 bits), delta is the decoder reconstruction */
+	int32_t delta = step >> 3;
+	if (difference >= step) {
+		code |= 4;
+		difference -= step;
+		delta += step;
+	}
+	step >>= 1;
+	if (difference >= step) {
+		code |= 2;
+		difference -= step;
+		delta += step;
+	}
+	step >>= 1;
+	if (difference >= step) {
+		code |= 1;
+		delta += step;
+	}
+
+	encoder->predictor = clamp_s16(encoder->predictor + ((code & 8) ? -delta : delta));
+	encoder->index = clamp_index(encoder->index + index_table[code & 7]);
+	return code;
+}
+
+/* Add one sample to the current block, return 1 when the block is complete */
+static inline uint8_t put_sample(Adpcm_encoder_t *encoder, int16_t sample) {
+	uint16_t fill = encoder->fill;
+
+	if (fill == 0) {
+
+		/* Block header : first sample as is, step index */
+		encoder->predictor = sample;
+		encoder->block[0] = low(sample);
+		encoder->block[1] = high(sample);
+		encoder->block[2] = encoder->index;
+		encoder->block[3] = 0;
+	} else {
+
+		/* Two codes per byte, low nibble first */
+		uint8_t code = encode_sample(encoder, sample);
+		uint8_t *byte = encoder->block + 4 + ((fill - 1) >> 1);
+		if (fill & 1)
+			*byte = code;
+		else
+			*byte |= code << 4;
+	}
+
+	encoder->last = sample;
+	encoder->fill = fill + 1;
+	if (encoder->fill < ADPCM_SAMPLES_PER_BLOCK)
+		return 0;
+	encoder->fill = 0;
+	return 1;
+}
+
+/* Copy the completed block to output */
+static inline void output_block(const Adpcm_encoder_t *encoder, uint8_t *output) {
+	for (uint16_t i = 0; i < ADPCM_BLOCK_ALIGN; ++i)
+		output[i] = encoder->block[i];
+}
+
+void adpcm_encoder_init(Adpcm_encoder_t *encoder) {
+	encoder->predictor = 0;
+	encoder->index = 0;
+	encoder->fill = 0;
+	encoder->last = 0;
+	encoder->samples = 0;
+}
+
+uint32_t adpcm_encode(Adpcm_encoder_t *encoder, const int16_t *samples, uint32_t count, uint8_t *output) {
+	uint32_t length = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		if (put_sample(encoder, samples[i])) {
+			output_block(encoder, output + length);
+			length += ADPCM_BLOCK_ALIGN;
+		}
+	}
+	encoder->samples += count;
+	return length;
+}
+
+uint32_t adpcm_encode_u8(Adpcm_encoder_t *encoder, const uint8_t *samples, uint32_t count, uint8_t *output) {
+	uint32_t length = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		if (put_sample(encoder, (int16_t)((samples[i] ^ 0x80) << 8))) {
+			output_block(encoder, output + length);
+			length += ADPCM_BLOCK_ALIGN;
+		}
+	}
+	encoder->samples += count;
+	return length;
+}
+
+uint32_t adpcm_flush(Adpcm_encoder_t *encoder, uint8_t *output) {
+	if (encoder->fill == 0)
+		return 0;
+	while (!put_sample(encoder, encoder->last))
+		;
+	output_block(encoder, output);
+	return ADPCM_BLOCK_ALIGN;
+}
+
+void adpcm_decode_block(const uint8_t *block, int16_t *samples) {
+	int16_t predictor = (int16_t)(block[0] | (block[1] << 8));
+	uint8_t index = clamp_index(block[2]);
+	samples[0] = predictor;
+
+	for (uint16_t i = 1; i < ADPCM_SAMPLES_PER_BLOCK; ++i) {
+		uint8_t byte = block[4 + ((i - 1) >> 1)];
+		uint8_t code = (i & 1) ? (byte & 0x0F) : (byte >> 4);
+
+		/* Reconstruction : (code magnitude + 0.5) x step / 4 */
+		int32_t step = step_table[index];
+		int32_t delta = step >> 3;
+		if (code & 4) delta += step;
+		if (code & 2) delta += step >> 1;
+		if (code & 1) delta += step >> 2;
+		predictor = clamp_s16(predictor + ((code & 8) ? -delta : delta));
+		index = clamp_index(index + index_table[code & 7]);
+		samples[i] = predictor;
+	}
+}
+
+#endif
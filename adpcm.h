@@ -0,0 +1,112 @@
+/**
+ * @file adpcm.h
+ * @brief Generic digital chiptune generator - IMA-ADPCM encoder and decoder
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle encode 16 bits samples to IMA-ADPCM (4 bits per sample, mono) by blocks,
+ * in the WAV (Microsoft IMA-ADPCM, format tag 0x11) block layout :
+ * a 4 bytes header (first sample, step index) followed by two samples per byte (low nibble first).\n
+ * Each block is decoded on its own (ADPCM_BLOCK_ALIGN bytes for ADPCM_SAMPLES_PER_BLOCK samples, 0.51 byte per sample).\n
+ * The encoder is streaming : any number of samples can be encoded per call, only whole blocks are output,
+ * the last partial block is padded with its last sample by adpcm_flush().\n
+ * The decoder is used to check the encoder (see tools/adpcm.c).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Only compiled when the port header define OUTPUT_SINK (used by the ADPCM sink, see sink.h)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _ADPCM_H_
+#define _ADPCM_H_
+
+/* Dependency */
+#include <stdint.h> // For hardcoded type
+
+/**
+ * Size of one encoded block (in bytes)
+ */
+#define ADPCM_BLOCK_ALIGN 256
+
+/**
+ * Number of samples of one encoded block (header sample + two samples per byte)
+ */
+#define ADPCM_SAMPLES_PER_BLOCK ((ADPCM_BLOCK_ALIGN - 4) * 2 + 1)
+
+/**
+ * Encoder structure
+ */
+typedef struct Adpcm_encoder_s {
+	int16_t predictor;                 // Last decoded sample (the encoder track the decoder)
+	uint8_t index;                     // Step index (0 to 88)
+	uint16_t fill;                     // Number of samples in current block
+	uint8_t block[ADPCM_BLOCK_ALIGN];  // Current block
+	int16_t last;                      // Last input sample (padding of last block)
+	uint32_t samples;                  // Number of samples encoded (without padding)
+} Adpcm_encoder_t;
+
+/**
+ * Reset an encoder
+ *
+ * @param encoder Pointer to an Adpcm_encoder_t object
+ */
+void adpcm_encoder_init(Adpcm_encoder_t *encoder);
+
+/**
+ * Encode samples
+ *
+ * @param encoder Pointer to an Adpcm_encoder_t object
+ * @param samples Input samples (16 bits signed)
+ * @param count Number of input samples
+ * @param output Output buffer of encoded blocks (ADPCM_BLOCK_ALIGN bytes for each block completed by the input samples)
+ * @return Number of bytes written to output (multiple of ADPCM_BLOCK_ALIGN)
+ */
+uint32_t adpcm_encode(Adpcm_encoder_t *encoder, const int16_t *samples, uint32_t count, uint8_t *output);
+
+/**
+ * Encode samples, 8 bits unsigned input
+ *
+ * @param encoder Pointer to an Adpcm_encoder_t object
+ * @param samples Input samples (8 bits unsigned, converted to (sample - 128) x 256)
+ * @param count Number of input samples
+ * @param output Output buffer of encoded blocks (see adpcm_encode())
+ * @return Number of bytes written to output (multiple of ADPCM_BLOCK_ALIGN)
+ */
+uint32_t adpcm_encode_u8(Adpcm_encoder_t *encoder, const uint8_t *samples, uint32_t count, uint8_t *output);
+
+/**
+ * Output the last partial block (padded with the last sample)
+ *
+ * @param encoder Pointer to an Adpcm_encoder_t object
+ * @param output Output buffer (ADPCM_BLOCK_ALIGN bytes)
+ * @return Number of bytes written to output (0 or ADPCM_BLOCK_ALIGN)
+ */
+uint32_t adpcm_flush(Adpcm_encoder_t *encoder, uint8_t *output);
+
+/**
+ * Decode one block
+ *
+ * @param block Encoded block (ADPCM_BLOCK_ALIGN bytes)
+ * @param samples Output samples (ADPCM_SAMPLES_PER_BLOCK samples, 16 bits signed)
+ */
+void adpcm_decode_block(const uint8_t *block, int16_t *samples);
+
+#endif // _ADPCM_H_
@@ -34,14 +34,38 @@
 /**
  * Output sample rate 
  */
+#ifndef SAMPLE_RATE
 #define SAMPLE_RATE 8000UL
+#endif
 
 /**
  * Number of channels 
  *
  * @warning Be sure you use the same number of channel in you tracker_data file !
  */
+#ifndef NUMBERS_OF_CHANNEL
 #define NUMBERS_OF_CHANNEL 6 //2
+#endif
+
+/**
+ * Number of user ADSR envelopes (ADSR_USER_1 to ADSR_USER_n, up to 16)
+ */
+#ifndef ADSR_ENVELOPES
+#define ADSR_ENVELOPES 16
+#define ADSR_ENVELOPES_DEFAULT // Not set by the user, a port can lower it
+#endif
+
+/**
+ * Instrument bank configuration (uncomment this define to apply waveform, duty, volume and ADSR envelope with one SET_INSTRUMENT opcode, see mixer.h)
+ */
+//#define INSTRUMENT_BANK
+
+/**
+ * Number of instruments of the instrument bank
+ */
+#ifndef INSTRUMENTS
+#define INSTRUMENTS 16
+#endif
 
 /**
  * Runtime configuration (uncomment this define if using a hardware timer)
@@ -53,8 +77,238 @@
  */
 #define SCALE_WITH_AUTO_OFFSET
 
+/**
+ * Gain stage configuration (uncomment one define for MCU without hardware multiplier, the port header can also select one, see scale_value() in mixer.h)
+ */
+//#define SCALE_SHIFT_ADD
+//#define SCALE_GAIN_TABLE
+
+/**
+ * Number of gain steps of SCALE_GAIN_TABLE (16 or 32, 256 bytes of PROGMEM per step)
+ */
+#ifndef GAIN_TABLE_STEPS
+#define GAIN_TABLE_STEPS 16
+#endif
+
+/**
+ * Wide output configuration (uncomment one define to output 16 bits signed or float32 samples instead of 8 bits unsigned, see mixer.h)
+ */
+//#define OUTPUT_S16
+//#define OUTPUT_F32
+
+/**
+ * Number of output channels (1 = mono, 2 = stereo, up to 8), each channel is panned on the output bus by SET_PAN (see mixer.h)
+ */
+#ifndef OUTPUT_CHANNELS
+#define OUTPUT_CHANNELS 1
+#endif
+
+/**
+ * Dither configuration (uncomment this define to add TPDF dither to 16 bits output)
+ */
+//#define OUTPUT_DITHER
+
+/**
+ * Offline render API configuration (uncomment this define to build render.c, computer only)
+ */
+//#define RENDER_API
+
+/**
+ * Number of samples between two engine state checkpoints of an offline render
+ */
+#define RENDER_CHECKPOINT_INTERVAL 1024UL
+
+/**
+ * Float engine configuration (uncomment this define to build float_engine.c, computer only, see float_engine.h)
+ */
+//#define FLOAT_ENGINE
+
+/**
+ * Stems configuration (uncomment this define to render the post-gain signal of each channel with the mix, computer only, see render.h)
+ */
+//#define STEM_OUTPUT
+
+/**
+ * Threaded output configuration (uncomment this define to render and output samples in two threads, linux port only)
+ */
+//#define THREADED_OUTPUT
+
+/**
+ * Paced output configuration (uncomment this define to render blocks in real-time on an absolute deadline schedule, linux port only)
+ */
+//#define PACED_OUTPUT
+
+/**
+ * Offline output configuration (uncomment this define to render as fast as possible with throughput statistics, linux port only)
+ */
+//#define OFFLINE_OUTPUT
+
+/**
+ * Fan-out output configuration (uncomment this define to render once and write several formats concurrently, one thread and bounded ring per output, linux port only, see fanout.h)
+ */
+//#define FANOUT_OUTPUT
+
+/**
+ * Maximum duration of player output modes in milliseconds (0 : until END_OF_STREAM)
+ */
+#define PLAYER_MAX_DURATION_MS 0
+
+/**
+ * Maximum number of loops of tracker file in player output modes (0 : until END_OF_STREAM)
+ */
+#define PLAYER_MAX_LOOPS 0
+
+/**
+ * Maximum number of opcodes executed by one tempo tick (more than NUMBERS_OF_CHANNEL, leftover opcodes of DIRECT_EXEC groups are deferred to next ticks)
+ */
+#ifndef TRACKER_TICK_BUDGET
+#define TRACKER_TICK_BUDGET 64
+#endif
+
+/**
+ * Voice pool configuration (uncomment this define to allocate the NUMBERS_OF_CHANNEL mixer channels to the logical channels of the tracker file at each note on, see voice.h)
+ */
+//#define VOICE_POOL
+
+/**
+ * Number of logical channels of the voice pool (up to 255, channels above 15 are addressed by the CHANNEL_PREFIX extended opcode)
+ */
+#ifndef VOICE_LOGICAL_CHANNELS
+#define VOICE_LOGICAL_CHANNELS 64
+#endif
+
+/**
+ * Voice stealing configuration (uncomment this define to steal the quietest voice instead of the oldest note when every voice is busy)
+ */
+//#define VOICE_STEAL_QUIETEST
+
+/**
+ * Modulation configuration (uncomment this define to drive tuning word, duty and volume of channels by control rate modulators : vibrato, arpeggio, portamento, PWM and volume slide, see modulation.h)
+ */
+//#define MODULATION
+
+/**
+ * Number of samples between two updates of the modulators (power of two, up to 128)
+ */
+#ifndef MODULATION_RATE
+#define MODULATION_RATE 32
+#endif
+
+/**
+ * ISR profiling configuration (uncomment this define to count cycles of each stage of the sampling ISR, see profile.h)
+ */
+//#define ISR_PROFILING
+
+/**
+ * Deadline monitor configuration (uncomment this define to check the render time of each sample against 1 / SAMPLE_RATE, see deadline.h)
+ */
+//#define DEADLINE_MONITOR
+
+/**
+ * Adaptive quality configuration (uncomment this define to degrade quality when the render time of a sample exceed its budget, see quality.h)
+ */
+//#define ADAPTIVE_QUALITY
+
+/**
+ * Render time on the target as a percentage of the measured render time (host simulation of deadline monitor and adaptive quality, 100 : measured CPU is the target)
+ */
+#define CPU_SLOWDOWN_PERCENT 100
+
 /* ----- General macro, do not edit anything after this line ----- */
 
+/**
+ * Player output modes, float engine and stems use the render API
+ */
+#if defined(THREADED_OUTPUT) || defined(PACED_OUTPUT) || defined(OFFLINE_OUTPUT) || defined(FANOUT_OUTPUT)
+#define PLAYER_OUTPUT
+#endif
+#if defined(PLAYER_OUTPUT) || defined(FLOAT_ENGINE) || defined(STEM_OUTPUT)
+#ifndef RENDER_API
+#define RENDER_API
+#endif
+#endif
+
+/**
+ * Output sample type and size of sampling ISR
+ */
+#if defined(OUTPUT_S16)
+#define WIDE_OUTPUT
+#define OUTPUT_SAMPLE_TYPE int16_t
+#define OUTPUT_SAMPLE_BITS 16
+#elif defined(OUTPUT_F32)
+#define WIDE_OUTPUT
+#define OUTPUT_SAMPLE_TYPE float
+#define OUTPUT_SAMPLE_BITS 32
+#else
+#define OUTPUT_SAMPLE_TYPE uint8_t
+#define OUTPUT_SAMPLE_BITS 8
+#endif
+#if defined(WIDE_OUTPUT) && defined(PLAYER_OUTPUT)
+#error "Player output modes render 8 bits samples, OUTPUT_S16 and OUTPUT_F32 need the sampling ISR"
+#endif
+
+/**
+ * Output bus size
+ */
+#if OUTPUT_CHANNELS < 1 || OUTPUT_CHANNELS > 8
+#error "OUTPUT_CHANNELS must be 1 to 8"
+#endif
+#if OUTPUT_CHANNELS > 1 && defined(PLAYER_OUTPUT)
+#error "Player output modes render mono samples, OUTPUT_CHANNELS > 1 need the sampling ISR"
+#endif
+
+/**
+ * Channels are addressed by one byte (CHANNEL_PREFIX), voice pool use 0xFF as "no voice / no channel"
+ */
+#if NUMBERS_OF_CHANNEL < 1 || NUMBERS_OF_CHANNEL > 255
+#error "NUMBERS_OF_CHANNEL must be 1 to 255"
+#endif
+#if defined(VOICE_POOL) && (VOICE_LOGICAL_CHANNELS < 1 || VOICE_LOGICAL_CHANNELS > 255)
+#error "VOICE_LOGICAL_CHANNELS must be 1 to 255"
+#endif
+
+/**
+ * Envelope and instrument tables size
+ */
+#if ADSR_ENVELOPES < 1 || ADSR_ENVELOPES > 16
+#error "ADSR_ENVELOPES must be 1 to 16"
+#endif
+#if defined(INSTRUMENT_BANK) && (INSTRUMENTS < 1 || INSTRUMENTS > 255)
+#error "INSTRUMENTS must be 1 to 255"
+#endif
+
+/**
+ * Modulators are updated when the low bits of an 8 bits sample counter wrap
+ */
+#if defined(MODULATION) && (MODULATION_RATE < 1 || MODULATION_RATE > 128 || (MODULATION_RATE & (MODULATION_RATE - 1)))
+#error "MODULATION_RATE must be a power of two from 1 to 128"
+#endif
+
+/**
+ * Gain table index is the high bits of the scale value
+ */
+#if GAIN_TABLE_STEPS == 16
+#define GAIN_TABLE_SHIFT 4
+#elif GAIN_TABLE_STEPS == 32
+#define GAIN_TABLE_SHIFT 3
+#else
+#error "GAIN_TABLE_STEPS must be 16 or 32"
+#endif
+
+/**
+ * ISR profiling, deadline monitor and adaptive quality use the cycle counter (see profile.h)
+ */
+#if defined(ISR_PROFILING) || defined(DEADLINE_MONITOR) || defined(ADAPTIVE_QUALITY)
+#define CYCLE_COUNTER
+#endif
+
+/**
+ * A tick must be able to execute one opcode per channel and start a direct exec group
+ */
+#if TRACKER_TICK_BUDGET <= NUMBERS_OF_CHANNEL
+#error "TRACKER_TICK_BUDGET must be greater than NUMBERS_OF_CHANNEL"
+#endif
+
 /**
  * Convert BPM to Tick compare value (according sample rate frequency)
  */
@@ -0,0 +1,164 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For tracker commands
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+#include "profile.h"      // For cycle counter
+#include "deadline.h"     // For deadline structure
+
+#ifdef DEADLINE_MONITOR
+
+/* Deadline statistics */
+volatile Deadline_stats_t deadline_stats;
+
+/* Current sample */
+uint8_t deadline_trace[DEADLINE_TRACE_LENGTH];
+uint16_t deadline_trace_length;
+uint32_t deadline_start_time;
+uint16_t deadline_start_index;
+
+void deadline_reset(void) {
+	deadline_stats.budget = profile_sample_budget();
+	deadline_stats.samples = 0;
+	deadline_stats.misses = 0;
+	deadline_stats.tick_misses = 0;
+	deadline_stats.untraced = 0;
+	for (uint8_t bucket = 0; bucket < DEADLINE_BUCKETS; ++bucket)
+		deadline_stats.histogram[bucket] = 0;
+	for (uint8_t opcode = 0; opcode < DEADLINE_OPCODES; ++opcode) {
+		deadline_stats.opcodes[opcode] = 0;
+		deadline_stats.miss_opcodes[opcode] = 0;
+	}
+	deadline_stats.worst_time = 0;
+	deadline_stats.worst_sample = 0;
+	deadline_stats.worst_tracker_index = 0;
+	deadline_stats.worst_trace_length = 0;
+	deadline_trace_length = 0;
+}
+
+void deadline_end_sample(void) {
+	uint32_t time = PROFILE_CYCLES() - deadline_start_time;
+	uint8_t traced = (deadline_trace_length < DEADLINE_TRACE_LENGTH) ? deadline_trace_length : DEADLINE_TRACE_LENGTH;
+
+	/* Load histogram */
+	uint32_t bucket = ((uint64_t)time * 8) / deadline_stats.budget;
+	++(deadline_stats.histogram[(bucket < DEADLINE_BUCKETS) ? bucket : DEADLINE_BUCKETS - 1]);
+
+	/* Deadline miss, attribute to opcodes of the tick */
+	if (time > deadline_stats.budget) {
+		++(deadline_stats.misses);
+		if (deadline_trace_length)
+			++(deadline_stats.tick_misses);
+		for (uint8_t i = 0; i < traced; ++i)
+			++(deadline_stats.miss_opcodes[deadline_trace[i] >> 4]);
+		deadline_stats.untraced += deadline_trace_length - traced;
+	}
+
+	/* Worst sample */
+	if (time > deadline_stats.worst_time) {
+		deadline_stats.worst_time = time;
+		deadline_stats.worst_sample = deadline_stats.samples;
+		deadline_stats.worst_tracker_index = deadline_start_index;
+		deadline_stats.worst_trace_length = deadline_trace_length;
+		for (uint8_t i = 0; i < traced; ++i)
+			deadline_stats.worst_trace[i] = deadline_trace[i];
+	}
+
+	++(deadline_stats.samples);
+}
+
+void deadline_snapshot(Deadline_stats_t *stats) {
+	stats->budget = deadline_stats.budget;
+	stats->samples = deadline_stats.samples;
+	stats->misses = deadline_stats.misses;
+	stats->tick_misses = deadline_stats.tick_misses;
+	stats->untraced = deadline_stats.untraced;
+	for (uint8_t bucket = 0; bucket < DEADLINE_BUCKETS; ++bucket)
+		stats->histogram[bucket] = deadline_stats.histogram[bucket];
+	for (uint8_t opcode = 0; opcode < DEADLINE_OPCODES; ++opcode) {
+		stats->opcodes[opcode] = deadline_stats.opcodes[opcode];
+		stats->miss_opcodes[opcode] = deadline_stats.miss_opcodes[opcode];
+	}
+	stats->worst_time = deadline_stats.worst_time;
+	stats->worst_sample = deadline_stats.worst_sample;
+	stats->worst_tracker_index = deadline_stats.worst_tracker_index;
+	stats->worst_trace_length = deadline_stats.worst_trace_length;
+	for (uint8_t i = 0; i < DEADLINE_TRACE_LENGTH; ++i)
+		stats->worst_trace[i] = deadline_stats.worst_trace[i];
+}
+
+#ifdef EMULATE_TIMER
+#include <stdio.h>        // For fprintf
+
+/* Opcode names (high nibble of command) */
+static const char *opcode_names[DEADLINE_OPCODES] = { "NO_ACTION", "SET_TEMPO", "SET_WAVE", "SET_VOLUME",
+		"SET_GLOBAL_VOLUME", "NOTE_ON", "NOTE_OFF", "END_OF_STREAM", "SOFTWARE_RESET", "SYNC_OSCILLATOR",
+		"RESET_OSCILLATOR", "SET_ADSR", "JUMP_IN_FILE", "SET_DUTY", "DIRECT_EXEC", "SET_ADSR_VALUES" };
+
+void deadline_dump(void) {
+	static Deadline_stats_t stats;
+	deadline_snapshot(&stats);
+	if (stats.samples == 0)
+		return;
+
+	/* Summary */
+	fprintf(stderr, "deadline: budget %lu cycles per sample (%u Hz, slowdown %u%%), %lu samples, %lu misses (%.3f%%), %lu during a tick\n",
+			(unsigned long)stats.budget, (unsigned int)SAMPLE_RATE, (unsigned int)CPU_SLOWDOWN_PERCENT,
+			(unsigned long)stats.samples, (unsigned long)stats.misses, 100.0 * stats.misses / stats.samples,
+			(unsigned long)stats.tick_misses);
+	fprintf(stderr, "deadline: worst sample %lu, %lu cycles (%.1f%% of budget), tracker index %u, %u opcodes :",
+			(unsigned long)stats.worst_sample, (unsigned long)stats.worst_time, 100.0 * stats.worst_time / stats.budget,
+			stats.worst_tracker_index, stats.worst_trace_length);
+	for (uint16_t i = 0; i < stats.worst_trace_length && i < DEADLINE_TRACE_LENGTH; ++i)
+		fprintf(stderr, " %02X", stats.worst_trace[i]);
+	fprintf(stderr, "%s\n", (stats.worst_trace_length > DEADLINE_TRACE_LENGTH) ? " ..." : "");
+
+	/* Load histogram */
+	fprintf(stderr, "%-18s %10s\n", "load (% budget)", "samples");
+	for (uint8_t bucket = 0; bucket < DEADLINE_BUCKETS; ++bucket) {
+		if (stats.histogram[bucket] == 0)
+			continue;
+		if (bucket == DEADLINE_BUCKETS - 1)
+			fprintf(stderr, ">= %-15u %10lu\n", bucket * 100 / 8, (unsigned long)stats.histogram[bucket]);
+		else
+			fprintf(stderr, "%4u - %-11u %10lu\n", bucket * 100 / 8, (bucket + 1) * 100 / 8, (unsigned long)stats.histogram[bucket]);
+	}
+
+	/* Opcodes of missed samples */
+	if (stats.misses == 0)
+		return;
+	fprintf(stderr, "%-18s %10s %10s\n", "opcode", "executed", "in misses");
+	for (uint8_t opcode = 0; opcode < DEADLINE_OPCODES; ++opcode) {
+		if (stats.opcodes[opcode] == 0)
+			continue;
+		fprintf(stderr, "%-18s %10lu %10lu\n", opcode_names[opcode], (unsigned long)stats.opcodes[opcode],
+				(unsigned long)stats.miss_opcodes[opcode]);
+	}
+	if (stats.untraced)
+		fprintf(stderr, "%-18s %10s %10lu\n", "(untraced)", "", (unsigned long)stats.untraced);
+}
+#endif
+
+#endif
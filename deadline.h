@@ -0,0 +1,152 @@
+/**
+ * @file deadline.h
+ * @brief Generic digital chiptune generator - Real-time deadline monitor
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle check the render time of each sample (mixer_render_sample()) against the sample period (1 / SAMPLE_RATE).\n
+ * It keep a histogram of the load (render time / sample period, 1/8 of period per bucket) and count deadline misses.\n
+ * Opcodes executed by the tracker during the tick of a missed sample are attributed to the miss (per opcode counters),
+ * and the worst sample is kept with its trace of opcodes.\n
+ * On computer, the monitor predict the feasibility on a MCU : CPU_SLOWDOWN_PERCENT scale the measured time
+ * to the target (like 2500 for a target 25 times slower than the computer, measure the ratio with bench_kernels).\n
+ * Time is read with PROFILE_CYCLES(), the budget is given by profile_sample_budget() (see profile.h).\n
+ * When DEADLINE_MONITOR is not defined every monitor call expand to nothing (zero overhead).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define DEADLINE_MONITOR in common.h to use this functions bundle, include profile.h before this file
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _DEADLINE_H_
+#define _DEADLINE_H_
+
+#ifdef DEADLINE_MONITOR
+
+/**
+ * Number of buckets of load histogram (1/8 of sample period per bucket, last bucket count all greater loads)
+ */
+#define DEADLINE_BUCKETS 32
+
+/**
+ * Maximum number of opcodes traced per sample (opcodes after this limit are counted but not attributed)
+ */
+#define DEADLINE_TRACE_LENGTH 32
+
+/**
+ * Number of opcodes (high nibble of command)
+ */
+#define DEADLINE_OPCODES 16
+
+/**
+ * Deadline statistics structure (counter units, see PROFILE_CYCLES())
+ */
+typedef struct {
+	uint32_t budget;                               // Sample period (scaled by CPU_SLOWDOWN_PERCENT)    
+	uint32_t samples;                              // Number of rendered samples
+	uint32_t misses;                               // Number of samples rendered in more than budget
+	uint32_t tick_misses;                          // Number of misses with at least one opcode executed
+	uint32_t untraced;                             // Number of opcodes of missed samples not attributed (trace full)
+	uint32_t histogram[DEADLINE_BUCKETS];          // Load histogram
+	uint32_t opcodes[DEADLINE_OPCODES];            // Number of executed opcodes
+	uint32_t miss_opcodes[DEADLINE_OPCODES];       // Number of executed opcodes during missed samples
+	uint32_t worst_time;                           // Render time of worst sample
+	uint32_t worst_sample;                         // Index of worst sample
+	uint16_t worst_tracker_index;                  // Tracker index at start of worst sample
+	uint16_t worst_trace_length;                   // Number of opcodes executed during worst sample
+	uint8_t worst_trace[DEADLINE_TRACE_LENGTH];    // Opcodes executed during worst sample
+} Deadline_stats_t;
+
+/**
+ * Deadline statistics (updated by the sampling ISR)
+ */
+extern volatile Deadline_stats_t deadline_stats;
+
+/**
+ * Opcodes executed during current sample
+ */
+extern uint8_t deadline_trace[DEADLINE_TRACE_LENGTH];
+extern uint16_t deadline_trace_length;
+
+/**
+ * Cycle counter and tracker index at start of current sample
+ */
+extern uint32_t deadline_start_time;
+extern uint16_t deadline_start_index;
+
+/**
+ * Reset statistics and compute the budget of one sample (call before the sampling timer start)
+ */
+void deadline_reset(void);
+
+/**
+ * Start monitoring a sample
+ */
+inline void deadline_begin_sample(void) {
+	deadline_trace_length = 0;
+	deadline_start_index = tracker_index;
+	deadline_start_time = PROFILE_CYCLES();
+}
+
+/**
+ * Record an opcode executed by the tracker (called by tracker_fetch_execute())
+ *
+ * @param command Command byte (opcode and channel)
+ */
+inline void deadline_opcode(uint8_t command) {
+	++(deadline_stats.opcodes[command >> 4]);
+	if (deadline_trace_length < DEADLINE_TRACE_LENGTH)
+		deadline_trace[deadline_trace_length] = command;
+	++deadline_trace_length;
+}
+
+/**
+ * End monitoring a sample (update histogram, misses and worst sample)
+ */
+void deadline_end_sample(void);
+
+/**
+ * Copy deadline statistics (can be called while the sampling ISR is running)
+ *
+ * @param stats Pointer to a Deadline_stats_t object
+ * @remarks The copy can be inconsistent if a sample end during the call
+ */
+void deadline_snapshot(Deadline_stats_t *stats);
+
+#ifdef EMULATE_TIMER
+/**
+ * Print deadline statistics on stderr (budget, misses, load histogram, opcodes of missed samples, worst sample)
+ */
+void deadline_dump(void);
+#endif
+
+#else
+
+/* Deadline monitor disabled : no code at all */
+#define deadline_reset()
+#define deadline_begin_sample()
+#define deadline_opcode(command)
+#define deadline_end_sample()
+#define deadline_dump()
+
+#endif
+
+#endif // _DEADLINE_H_
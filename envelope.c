@@ -29,10 +29,22 @@
 /**
  * ADSR envelopes
  */
-volatile Envelope_type_t adsr_envelopes[NUMBERS_OF_CHANNEL] = {
+volatile Envelope_type_t adsr_envelopes[ADSR_ENVELOPES] = {
 	{ 0, 0, 0, 0 }
 };
 
+/**
+ * Timer compare of one envelope step (255 steps) from a time in ms (ticks x 1024 / 255, the timer is incremented by 1024 per sample)
+ */
+#define STEP_COMPARE(ms) (((uint32_t)(uint16_t)MS_TO_TICK(ms) * 1024) / 255)
+
+#ifdef ADAPTIVE_QUALITY
+/**
+ * Number of samples processed by the next call (control rate)
+ */
+volatile uint8_t envelope_ticks = 1;
+#endif
+
 void reset_envelope(volatile Envelope_t *envelope, uint8_t state) {
 
 	if (envelope->type == ADSR_NONE)
@@ -46,12 +58,12 @@ void reset_envelope(volatile Envelope_t *envelope, uint8_t state) {
 
 	switch (state) {
 	case ENV_ATTACK:
-		subtimer_set_compare(&(envelope->value_change_timer), (adsr_envelopes[envelope->type - 1].attack * 1024) / 255);
+		subtimer_set_compare(&(envelope->value_change_timer), adsr_envelopes[envelope->type - 1].attack);
 	break;
 
 	case ENV_DECAY:
 		envelope->value = 255;
-		subtimer_set_compare(&(envelope->value_change_timer), (adsr_envelopes[envelope->type - 1].decay * 1024) / 255);
+		subtimer_set_compare(&(envelope->value_change_timer), adsr_envelopes[envelope->type - 1].decay);
 	break;
 		
 	case ENV_SUSTAIN:
@@ -62,13 +74,35 @@ void reset_envelope(volatile Envelope_t *envelope, uint8_t state) {
 	case ENV_RELEASE:
 		if(envelope->ended) break;
 		envelope->value = adsr_envelopes[envelope->type - 1].sustain_level;
-		subtimer_set_compare(&(envelope->value_change_timer), (adsr_envelopes[envelope->type - 1].release * 1024) / 255);
+		subtimer_set_compare(&(envelope->value_change_timer), adsr_envelopes[envelope->type - 1].release);
 	break;
 	}
 
 	envelope->ended = 0;
 }
 
+/* Increment or decrement value of an envelope (timer compare match) */
+static inline void step_envelope(volatile Envelope_t *envelope) {
+	if (envelope->state == ENV_ATTACK) {
+		if((uint16_t)envelope->value + 1 >= 255) {
+			reset_envelope(envelope, ENV_DECAY); // Attack -> Decay
+		} else
+			++(envelope->value);
+
+	} else if (envelope->state == ENV_DECAY) {
+		if((int16_t)envelope->value - 1 <= adsr_envelopes[envelope->type - 1].sustain_level) {
+			reset_envelope(envelope, ENV_SUSTAIN); // Decay -> Sustain
+		} else
+			--(envelope->value);
+
+	} else if (envelope->state == ENV_RELEASE) {
+		if((int16_t)envelope->value - 1 <= 0) {
+			envelope->ended = 1; // Release -> end
+		} else
+			--(envelope->value);
+	}
+}
+
 uint8_t get_envelope_sample(volatile Envelope_t *envelope) {
 
 	/* Check for ADSR */
@@ -80,41 +114,36 @@ uint8_t get_envelope_sample(volatile Envelope_t *envelope) {
 		return 0;
 
 	/* Handle SubTimer (for envelope value change) */
-	if (subtimer_tick_increment(&(envelope->value_change_timer), 1024)) {
-
-		/* Increment or decrement value */
-		if (envelope->state == ENV_ATTACK) {
-			if((uint16_t)envelope->value + 1 >= 255) {
-				reset_envelope(envelope, ENV_DECAY); // Attack -> Decay
-			} else
-				++(envelope->value);
-
-		} else if (envelope->state == ENV_DECAY) {
-			if((int16_t)envelope->value - 1 <= adsr_envelopes[envelope->type - 1].sustain_level) {
-				reset_envelope(envelope, ENV_SUSTAIN); // Decay -> Sustain
-			} else
-				--(envelope->value);
-
-		} else if (envelope->state == ENV_RELEASE) {
-			if((int16_t)envelope->value - 1 <= 0) {
-				envelope->ended = 1; // Release -> end
-			} else
-				--(envelope->value);
-		}
-
-	}
+#ifdef ADAPTIVE_QUALITY
+	/* Control rate : every sample since the last call, same as one subtimer_tick_increment() call per sample */
+	uint8_t ticks = envelope_ticks;
+	while (!envelope->ended && subtimer_tick_batch(&(envelope->value_change_timer), ENVELOPE_INCREMENT, &ticks))
+		step_envelope(envelope);
+#else
+	if (subtimer_tick_increment(&(envelope->value_change_timer), ENVELOPE_INCREMENT))
+		step_envelope(envelope);
+#endif
 
 	/* Return sample */
 	return envelope->value;
 }
 
 void setup_adsr_envelope(uint8_t envelope, uint16_t attack, uint16_t decay, uint8_t sustain_level, uint16_t release) {
-	if (envelope == ADSR_NONE || envelope > NUMBERS_OF_CHANNEL + 1) { // Overflow check
+	if (envelope == ADSR_NONE || envelope > ADSR_ENVELOPES) { // Overflow check
 		return;
 	}
 	--envelope; // Ignore ADSR_NONE
-	adsr_envelopes[envelope].attack	= MS_TO_TICK(attack);
-	adsr_envelopes[envelope].decay = MS_TO_TICK(decay);
+	adsr_envelopes[envelope].attack	= STEP_COMPARE(attack);
+	adsr_envelopes[envelope].decay = STEP_COMPARE(decay);
 	adsr_envelopes[envelope].sustain_level = sustain_level;		
-	adsr_envelopes[envelope].release = MS_TO_TICK(release);
+	adsr_envelopes[envelope].release = STEP_COMPARE(release);
+}
+
+void clear_adsr_envelopes(void) {
+	for (uint8_t envelope = 0; envelope < ADSR_ENVELOPES; ++envelope) {
+		adsr_envelopes[envelope].attack = 0;
+		adsr_envelopes[envelope].decay = 0;
+		adsr_envelopes[envelope].sustain_level = 0;
+		adsr_envelopes[envelope].release = 0;
+	}
 }
@@ -67,13 +67,13 @@ typedef enum {
 } ADSR_state_t;
 
 /**
- * ADSR envelope component structure
+ * ADSR envelope component structure (resolved once by setup_adsr_envelope())
  */
 typedef struct {
-	uint16_t attack;
-	uint16_t decay;
+	uint32_t attack;       // Timer compare of one attack step (ticks x 1024 / 255)
+	uint32_t decay;        // Timer compare of one decay step
 	uint8_t sustain_level;
-	uint16_t release;
+	uint32_t release;      // Timer compare of one release step
 } Envelope_type_t;
 
 /**
@@ -87,6 +87,23 @@ typedef struct {
 	SubTimer_t value_change_timer;
 } Envelope_t;
 
+/**
+ * ADSR envelopes (ADSR_USER_1 to ADSR_USER_n, n = ADSR_ENVELOPES)
+ */
+extern volatile Envelope_type_t adsr_envelopes[ADSR_ENVELOPES];
+
+/**
+ * Envelope timer increment per sample
+ */
+#define ENVELOPE_INCREMENT 1024
+
+#ifdef ADAPTIVE_QUALITY
+/**
+ * Number of samples processed by the next call of get_envelope_sample() (set by the mixer at control rate, see quality.h)
+ */
+extern volatile uint8_t envelope_ticks;
+#endif
+
 /**
  * Reset ADSR envelope
  *
@@ -104,9 +121,9 @@ void reset_envelope(volatile Envelope_t *envelope, uint8_t state);
 uint8_t get_envelope_sample(volatile Envelope_t *envelope);
 
 /**
- * Setup ADSR envelope
+ * Setup ADSR envelope (times are converted to timer compares of one step once, not at each note)
  *
- * @param envelope Envelope index
+ * @param envelope Envelope index (ADSR_USER_1 to ADSR_USER_n, n = ADSR_ENVELOPES)
  * @param attack Attack time in ms
  * @param decay Decay time in ms
  * @param sustain_level Sustain volume level
@@ -114,4 +131,9 @@ uint8_t get_envelope_sample(volatile Envelope_t *envelope);
  */
 void setup_adsr_envelope(uint8_t envelope, uint16_t attack, uint16_t decay, uint8_t sustain_level, uint16_t release);
 
+/**
+ * Clear all user ADSR envelopes
+ */
+void clear_adsr_envelopes(void);
+
 #endif // _ENVELOPE_H_
@@ -0,0 +1,199 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For tracker commands
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+
+#ifdef FANOUT_OUTPUT
+
+#include <stdio.h>        // For statistics output
+#include <stdlib.h>       // For malloc
+#include <string.h>       // For memcpy
+#include <time.h>         // For clock_gettime
+#include <pthread.h>      // For output threads
+#include "ring.h"         // For ring structure
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool
+#include "render.h"       // For render session
+#include "player.h"       // For player structure
+#include "fanout.h"       // For fan-out structure
+
+/* Nanoseconds per second */
+#define NS_PER_SECOND 1000000000ULL
+
+/* Get monotonic time in nanoseconds */
+static inline uint64_t get_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+/* Convert 8 bits unsigned samples to 16 bits signed (little-endian) */
+static uint32_t convert_s16(void *state, const uint8_t *samples, uint32_t count, uint8_t *output) {
+	(void)state; // Stateless conversion
+	for (uint32_t i = 0; i < count; ++i) {
+		output[2 * i] = 0;
+		output[2 * i + 1] = samples[i] ^ 0x80; // (sample - 128) << 8
+	}
+	return count * 2;
+}
+
+const Fanout_format_t fanout_format_u8 = { "u8", 8, 1, NULL, NULL };
+const Fanout_format_t fanout_format_s16 = { "s16", 16, 2, convert_s16, NULL };
+
+/* Output thread context */
+typedef struct {
+	Ring_t ring;
+	Fanout_output_t *output;
+	uint8_t *buffer; // Conversion buffer
+	pthread_t thread;
+} Fanout_context_t;
+
+/* Output thread (consumer) */
+static void *output_thread(void *arg) {
+	Fanout_context_t *context = arg;
+	Fanout_output_t *output = context->output;
+	const Fanout_format_t *format = output->format;
+	const uint8_t *block;
+	uint32_t length;
+
+	while ((block = ring_acquire_read(&(context->ring), &length))) {
+		uint64_t start = get_time_ns();
+		if (format->convert) {
+			uint32_t bytes = format->convert(output->state, block, length, context->buffer);
+			if (!sink_write(output->sink, context->buffer, bytes))
+				output->error = 1; // Keep draining, render thread may be waiting
+		} else if (!sink_write(output->sink, block, length)) {
+			output->error = 1;
+		}
+		output->samples += length;
+		ring_release_read(&(context->ring));
+		output->busy_ns += get_time_ns() - start;
+	}
+
+	/* Samples buffered by the encoder */
+	if (format->flush) {
+		uint32_t bytes = format->flush(output->state, context->buffer);
+		if (bytes && !sink_write(output->sink, context->buffer, bytes))
+			output->error = 1;
+	}
+	return NULL;
+}
+
+uint8_t fanout_run(const Player_config_t *config, Fanout_output_t *outputs, uint8_t count, Player_stats_t *stats) {
+	Fanout_context_t contexts[FANOUT_MAX_OUTPUTS];
+	uint8_t *blocks[FANOUT_MAX_OUTPUTS];
+	Render_session_t session;
+	uint8_t started = 0;
+	uint8_t success = 1;
+
+	if (count == 0 || count > FANOUT_MAX_OUTPUTS)
+		return 0;
+
+	/* Clear statistics */
+	*stats = (Player_stats_t) { 0 };
+	for (uint8_t i = 0; i < count; ++i) {
+		outputs[i].samples = 0;
+		outputs[i].busy_ns = 0;
+		outputs[i].stall_ns = 0;
+		outputs[i].max_fill = 0;
+		outputs[i].underruns = 0;
+		outputs[i].error = 0;
+	}
+
+	/* Start one thread per output */
+	uint64_t start = get_time_ns();
+	for (; started < count; ++started) {
+		Fanout_context_t *context = contexts + started;
+		context->output = outputs + started;
+		context->buffer = malloc((size_t)config->block_size * outputs[started].format->max_bytes);
+		if (!context->buffer)
+			break;
+		if (!ring_init(&(context->ring), config->depth, config->block_size, config->high_watermark, config->low_watermark)) {
+			free(context->buffer);
+			break;
+		}
+		if (pthread_create(&(context->thread), NULL, output_thread, context)) {
+			ring_free(&(context->ring));
+			free(context->buffer);
+			break;
+		}
+	}
+
+	/* Render thread (producer), one render for all outputs */
+	if (started == count) {
+		render_start(&session, &(config->limits));
+		while (session.status == RENDER_OK) {
+
+			/* Wait for a free block in each ring (the slowest output set the pace) */
+			for (uint8_t i = 0; i < count; ++i) {
+				uint64_t wait_start = get_time_ns();
+				blocks[i] = ring_acquire_write(&(contexts[i].ring));
+				outputs[i].stall_ns += get_time_ns() - wait_start;
+			}
+
+			/* Render once, copy to the other outputs */
+			uint32_t length = render_samples(&session, blocks[0], config->block_size);
+			for (uint8_t i = 1; i < count; ++i)
+				memcpy(blocks[i], blocks[0], length);
+			for (uint8_t i = 0; i < count; ++i)
+				ring_commit_write(&(contexts[i].ring), length);
+			stats->samples += length;
+		}
+		stats->status = session.status;
+	} else {
+		success = 0;
+	}
+
+	/* Wait end of output threads */
+	for (uint8_t i = 0; i < started; ++i) {
+		ring_close(&(contexts[i].ring));
+		pthread_join(contexts[i].thread, NULL);
+		outputs[i].max_fill = contexts[i].ring.max_fill;
+		outputs[i].underruns = contexts[i].ring.underruns;
+		stats->underruns += contexts[i].ring.underruns;
+		stats->throttles += contexts[i].ring.throttles;
+		if (contexts[i].ring.max_fill > stats->max_fill)
+			stats->max_fill = contexts[i].ring.max_fill;
+		if (outputs[i].error)
+			success = 0;
+		ring_free(&(contexts[i].ring));
+		free(contexts[i].buffer);
+	}
+
+	stats->elapsed_ns = get_time_ns() - start;
+	return success;
+}
+
+void fanout_print_stats(const Fanout_output_t *outputs, uint8_t count) {
+	for (uint8_t i = 0; i < count; ++i) {
+		fprintf(stderr, "%s : %llu samples, %llu bytes, busy %.3f s, render waited %.3f s, %u underruns, max %u blocks ready%s\n",
+				outputs[i].format->name, (unsigned long long)outputs[i].samples, (unsigned long long)outputs[i].sink->length,
+				(double)outputs[i].busy_ns / NS_PER_SECOND, (double)outputs[i].stall_ns / NS_PER_SECOND,
+				outputs[i].underruns, outputs[i].max_fill, outputs[i].error ? ", write error" : "");
+	}
+}
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file fanout.h
+ * @brief Generic digital chiptune generator - Fan-out output
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle render a tracker file once and write it to several sinks concurrently, each in its own format.\n
+ * The render thread (producer) write each block of 8 bits samples to one ring per output (see ring.h),
+ * each output has its own thread (consumer) which convert the blocks to its format and write them to its sink.\n
+ * Rings are bounded : a slow output (encoder or sink) stop the render at the high watermark of its ring (backpressure),
+ * the time the render thread spent waiting for each output is measured.\n
+ * A format is a converter from 8 bits samples to the bytes of the output, with a flush function for encoders
+ * which buffer samples (called once at end of render).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define FANOUT_OUTPUT in common.h to use this functions bundle (linux port only)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _FANOUT_H_
+#define _FANOUT_H_
+
+/**
+ * Maximum number of outputs
+ */
+#define FANOUT_MAX_OUTPUTS 8
+
+/**
+ * Output format structure
+ */
+typedef struct {
+	const char *name;
+	uint8_t bits_per_sample; // Sample format of the sink (WAV header)
+	uint8_t max_bytes;       // Maximum number of output bytes per input sample (size of conversion buffer)
+	uint32_t (*convert)(void *state, const uint8_t *samples, uint32_t count, uint8_t *output); // Return number of output bytes, NULL : 8 bits samples as is
+	uint32_t (*flush)(void *state, uint8_t *output);                                         // Return number of output bytes, NULL : nothing buffered
+} Fanout_format_t;
+
+/**
+ * 8 bits unsigned output format (samples as rendered)
+ */
+extern const Fanout_format_t fanout_format_u8;
+
+/**
+ * 16 bits signed output format (little-endian)
+ */
+extern const Fanout_format_t fanout_format_s16;
+
+/**
+ * Output structure
+ */
+typedef struct {
+	const Fanout_format_t *format;
+	void *state;         // State of format converter (NULL if not used)
+	Sink_t *sink;        // Opened sink (sample format of the format)
+	uint64_t samples;    // Number of samples converted (filled by fanout_run())
+	uint64_t busy_ns;    // Time spent converting and writing (filled by fanout_run())
+	uint64_t stall_ns;   // Time the render thread waited for this output (filled by fanout_run())
+	uint32_t max_fill;   // Maximum number of ready blocks (filled by fanout_run())
+	uint32_t underruns;  // Number of time the output thread found its ring empty (filled by fanout_run())
+	uint8_t error;       // Set on sink error (filled by fanout_run())
+} Fanout_output_t;
+
+/**
+ * Render the tracker file once in a render thread and write it to each output in its own thread
+ *
+ * @param config Pointer to a Player_config_t object (block size, ring depth and watermarks of each output, limits)
+ * @param outputs Array of Fanout_output_t objects (statistics are filled at end of render)
+ * @param count Number of outputs (1 to FANOUT_MAX_OUTPUTS)
+ * @param stats Pointer to a Player_stats_t object (filled at end of render, underruns / throttles are the sum of all outputs)
+ * @return 1 on success, 0 on error
+ * @remarks Sinks are not closed
+ */
+uint8_t fanout_run(const Player_config_t *config, Fanout_output_t *outputs, uint8_t count, Player_stats_t *stats);
+
+/**
+ * Print statistics of each output on stderr
+ *
+ * @param outputs Array of Fanout_output_t objects
+ * @param count Number of outputs
+ */
+void fanout_print_stats(const Fanout_output_t *outputs, uint8_t count);
+
+#endif // _FANOUT_H_
@@ -0,0 +1,269 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>         // For hardcoded type
+#include <math.h>           // For fabsf, copysignf
+#include "common.h"         // For common macro
+#include "port.h"           // For platform dependent macro
+#include "tracker.h"        // For tracker commands
+#include "tracker_data.h"   // For english note notation
+#include "subtimer.h"       // For SubTimer structure
+#include "envelope.h"       // For ADSR envelope name
+#include "oscillator.h"     // For Waveform name
+#include "mixer.h"          // For channel name
+#include "modulation.h"     // For modulators
+#include "voice.h"          // For voice pool
+#include "render.h"         // For render session
+#include "float_engine.h"   // For float engine
+
+#ifdef FLOAT_ENGINE
+
+/* Tempo timer (see tracker.c) */
+extern volatile SubTimer_t tempo_timer;
+
+/* Oscillator phases (0.0 to 1.0) */
+static float phases[NUMBERS_OF_CHANNEL];
+
+/* Phase accumulators written back at end of last block (detect SYNC_OSCILLATOR / RESET_OSCILLATOR) */
+static uint8_t phase_accumulators[NUMBERS_OF_CHANNEL];
+
+#if OUTPUT_CHANNELS > 1
+/* Pan of each channel and matching gain of each output (updated on pan change) */
+static uint8_t pans[NUMBERS_OF_CHANNEL];
+static float pan_gains[NUMBERS_OF_CHANNEL][OUTPUT_CHANNELS];
+#endif
+
+/* Fractional part of a positive value */
+static inline float wrap(float value) {
+	return value - (float)(int32_t)value;
+}
+
+/* Sinus of 2 x pi x phase, odd polynomial on -pi/2 to pi/2 (error under 4e-6, no branch) */
+static inline float sinus(float phase) {
+	float t = 1.0f - 2.0f * phase;                          // sin(2 pi phase) = sin(pi t), t = -1.0 to 1.0
+	float magnitude = 0.5f - fabsf(fabsf(t) - 0.5f);        // sin(pi - x) = sin(x)
+	float x = copysignf(3.14159265f * magnitude, t);
+	float x2 = x * x;
+	return x * (1.0f + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880)))));
+}
+
+#if OUTPUT_CHANNELS > 1
+/* Compute gain of each output of a channel (same equal power law as mixer_update_pan_gains(), without quantization) */
+static void update_pan_gains(uint8_t channel) {
+	pans[channel] = mixer.channels[channel].pan;
+	uint8_t pan = pans[channel];
+	float position = ((pan <= 128) ? pan * (1.0f / 256) : 0.5f + (pan - 128) * (1.0f / 254)) * (OUTPUT_CHANNELS - 1);
+	uint8_t output = (uint8_t)position;
+	if (output == OUTPUT_CHANNELS - 1) // Last output
+		output = OUTPUT_CHANNELS - 2;
+	float fraction = position - output;
+	for (uint8_t i = 0; i < OUTPUT_CHANNELS; ++i)
+		pan_gains[channel][i] = 0;
+	pan_gains[channel][output] = sinus((1.0f - fraction) * 0.25f);
+	pan_gains[channel][output + 1] = sinus(fraction * 0.25f);
+}
+#endif
+
+/* Check if an envelope keep the same value during length samples (no timer event, same as length get_envelope_sample() calls) */
+static inline uint8_t envelope_steady(volatile Envelope_t *envelope, uint16_t length) {
+	if (envelope->type == ADSR_NONE || envelope->ended)
+		return 1;
+	uint32_t counter = subtimer_get_counter(&(envelope->value_change_timer));
+	uint32_t compare = subtimer_get_compare(&(envelope->value_change_timer));
+	return counter < compare && (compare - counter) > (uint32_t)(length - 1) * ENVELOPE_INCREMENT;
+}
+
+/* Render a block of a channel, add it to the mix of each output (loops run on the whole block to be vectorized, samples after length are not used) */
+static void render_channel(uint8_t channel, float mix[][FLOAT_ENGINE_BLOCK_SIZE], uint16_t length) {
+	volatile Channel_t *source = &(mixer.channels[channel]);
+	float gains[FLOAT_ENGINE_BLOCK_SIZE];
+	float wave[FLOAT_ENGINE_BLOCK_SIZE];
+
+	/* Combined gain (envelope x volume), envelopes are shared with the fixed-point engine */
+	float volume = source->volume * (1.0f / (255.0f * 255.0f));
+	if (envelope_steady(&(source->envelope), length)) {
+		float gain = get_envelope_sample(&(source->envelope)) * volume;
+		if (source->envelope.type != ADSR_NONE && !source->envelope.ended)
+			source->envelope.value_change_timer.tick_counter += (uint32_t)(length - 1) * ENVELOPE_INCREMENT;
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			gains[i] = gain;
+	} else {
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			gains[i] = (i < length) ? get_envelope_sample(&(source->envelope)) * volume : 0;
+	}
+
+	/* Phase changed by an opcode */
+	if (source->oscillator.phase_accumulator != phase_accumulators[channel])
+		phases[channel] = source->oscillator.phase_accumulator * (1.0f / 256);
+	float phase = phases[channel];
+	float increment = source->oscillator.tunning_word * (1.0f / 256);
+
+	/* Waveform (same shapes and phases as oscillator.c) */
+	uint8_t silent = 0;
+	switch (source->oscillator.waveform) {
+	case WF_SINUS:
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			wave[i] = sinus(wrap(phase + i * increment));
+		break;
+
+	case WF_TRIANGLE:
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i) {
+			float offset = wrap(phase + i * increment + 0.25f) - 0.5f;
+			wave[i] = 4.0f * ((offset < 0) ? -offset : offset) - 1.0f;
+		}
+		break;
+
+	case WF_SQUARE: {
+		float duty = (source->oscillator.duty + 1) * (1.0f / 256);
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			wave[i] = (wrap(phase + i * increment) >= duty) ? -1.0f : 1.0f;
+		break;
+	}
+
+	case WF_SAWTOOTH:
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			wave[i] = 2.0f * wrap(phase + i * increment + 0.5f) - 1.0f;
+		break;
+
+	case WF_NOISE: // Same noise sequence for any block length
+		for (uint16_t i = 0; i < length; ++i) {
+			noise_seed ^= (noise_seed << 13);
+			noise_seed ^= (noise_seed >> 17);
+			noise_seed ^= (noise_seed << 5);
+			wave[i] = (noise_seed >> 8) * (2.0f / (1UL << 24)) - 1.0f;
+		}
+		break;
+
+	case WF_DC: {
+		float value = (source->oscillator.duty - 127.5f) * (1.0f / 127.5f);
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			wave[i] = value;
+		break;
+	}
+
+	default: // WF_NONE
+		silent = 1;
+		break;
+	}
+
+	/* Mix */
+	if (!silent) {
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			wave[i] *= gains[i];
+#if OUTPUT_CHANNELS > 1
+		if (source->pan != pans[channel])
+			update_pan_gains(channel);
+		for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output) {
+			float pan_gain = pan_gains[channel][output];
+			if (pan_gain == 0)
+				continue;
+			for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+				mix[output][i] += wave[i] * pan_gain;
+		}
+#else
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			mix[0][i] += wave[i];
+#endif
+	}
+
+	/* Next phase, written back for the tracker (sync of oscillators) */
+	phases[channel] = wrap(phase + length * increment);
+	phase_accumulators[channel] = (uint8_t)(phases[channel] * 256);
+	source->oscillator.phase_accumulator = phase_accumulators[channel];
+}
+
+/* Render a block of frames (no tempo tick) */
+static void render_block(float *buffer, uint16_t length) {
+	float mix[OUTPUT_CHANNELS][FLOAT_ENGINE_BLOCK_SIZE];
+	for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output)
+		for (uint16_t i = 0; i < FLOAT_ENGINE_BLOCK_SIZE; ++i)
+			mix[output][i] = 0;
+
+	/* For each channels of mixer */
+	for (uint8_t channel = 0; channel < MIXER_VOICES; ++channel)
+		render_channel(channel, mix, length);
+
+	/* Global volume and normalization (no clipping) */
+	float gain = mixer.global_volume * (1.0f / (255.0f * NUMBERS_OF_CHANNEL));
+	for (uint16_t i = 0; i < length; ++i)
+		for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output)
+			buffer[i * OUTPUT_CHANNELS + output] = mix[output][i] * gain;
+}
+
+void float_engine_reset(void) {
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		phase_accumulators[channel] = mixer.channels[channel].oscillator.phase_accumulator;
+		phases[channel] = phase_accumulators[channel] * (1.0f / 256);
+#if OUTPUT_CHANNELS > 1
+		update_pan_gains(channel);
+#endif
+	}
+}
+
+uint32_t float_engine_render(Render_session_t *session, float *buffer, uint32_t size) {
+	uint32_t count = 0;
+
+	while (count < size && session->status == RENDER_OK) {
+
+		/* Check duration */
+		if (session->limits.max_samples && session->position >= session->limits.max_samples) {
+			session->status = RENDER_DURATION_LIMIT;
+			break;
+		}
+
+		/* Tempo tick of the first sample, drop it if it start the end of the song */
+		tracker_tempo_tick();
+		modulation_sample();
+		if (tracker_end_of_stream) {
+			session->status = RENDER_END_OF_STREAM;
+			break;
+		}
+		if (session->limits.max_loops && tracker_loop_count >= session->limits.max_loops) {
+			session->status = RENDER_LOOP_LIMIT;
+			break;
+		}
+
+		/* Block length : up to the next tempo tick */
+		uint32_t length = size - count;
+		if (length > FLOAT_ENGINE_BLOCK_SIZE)
+			length = FLOAT_ENGINE_BLOCK_SIZE;
+		uint32_t counter = subtimer_get_counter(&tempo_timer), compare = subtimer_get_compare(&tempo_timer);
+		uint32_t ticks_left = (compare > counter) ? compare - counter : 0;
+		if (length > ticks_left + 1)
+			length = ticks_left + 1;
+#ifdef MODULATION
+		uint8_t samples_left = MODULATION_RATE - (modulation.phase & (MODULATION_RATE - 1)); // Up to the next modulators update
+		if (length > samples_left)
+			length = samples_left;
+#endif
+		if (session->limits.max_samples && length > session->limits.max_samples - session->position)
+			length = session->limits.max_samples - session->position;
+		tempo_timer.tick_counter += length - 1; // Tempo ticks of the other samples (no compare match)
+#ifdef MODULATION
+		modulation.phase += length - 1;
+#endif
+
+		render_block(buffer + count * OUTPUT_CHANNELS, length);
+		count += length;
+		session->position += length;
+	}
+
+	return count;
+}
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file float_engine.h
+ * @brief Generic digital chiptune generator - Float32 engine
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle render a tracker file with float32 oscillators, gains and mixing, for computer builds.\n
+ * The tracker front end (tracker.c), the mixer control state and the ADSR envelopes are the same as the fixed-point engine,
+ * only the signal path is replaced : float waveforms (no 8 bits quantization, polynomial sinus instead of the 8 bits table),
+ * and one float gain per channel (envelope x volume) instead of the scale_value() chain.\n
+ * Samples are rendered by blocks which end before the next tempo tick or modulators update (up to FLOAT_ENGINE_BLOCK_SIZE samples) :
+ * the channel parameters are constant during a block, each channel is rendered by loops over the samples of the block
+ * (no per sample branch, vectorized by the compiler).\n
+ * Noise is regenerated once per sample for each noise channel only (the sequence is not the fixed-point engine one).\n
+ * With OUTPUT_CHANNELS > 1 each channel is added to each output with the float gain of its pan (same equal power law
+ * as the fixed-point engine, recomputed on pan change only), frames are interleaved.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define FLOAT_ENGINE in common.h to use this functions bundle (computer only, it define RENDER_API too)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _FLOAT_ENGINE_H_
+#define _FLOAT_ENGINE_H_
+
+/**
+ * Maximum number of samples of a block
+ */
+#define FLOAT_ENGINE_BLOCK_SIZE 64
+
+/**
+ * Reset float oscillators (call after render_start())
+ */
+void float_engine_reset(void);
+
+/**
+ * Render frames of a session with the float engine
+ *
+ * @param session Pointer to a Render_session_t object (see render.h)
+ * @param buffer Output buffer (interleaved frames of OUTPUT_CHANNELS float32 samples, -1.0 to 1.0)
+ * @param size Size of output buffer (in frames)
+ * @return Number of frames rendered, less than size if session status is not RENDER_OK anymore
+ */
+uint32_t float_engine_render(Render_session_t *session, float *buffer, uint32_t size);
+
+#endif // _FLOAT_ENGINE_H_
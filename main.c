@@ -48,8 +48,22 @@
 #include "envelope.h"     // For ADSR envelope name
 #include "oscillator.h"   // For Waveform name
 #include "mixer.h"        // For channel name
+#include "profile.h"      // For ISR profiling
+#include "deadline.h"     // For deadline monitor
+#include "quality.h"      // For adaptive quality
+
+#ifdef PLAYER_OUTPUT
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool
+#include "render.h"       // For render session
+#include "player.h"       // For player run modes
+#endif
+#ifdef FANOUT_OUTPUT
+#include "fanout.h"       // For fan-out output
+#endif
 
 #ifdef EMULATE_TIMER
+#include <stdio.h>        // For puts
 extern TIMER_ISR_FUNCTION;
 #endif
 
@@ -62,17 +76,87 @@ int main(void) {
 
 	/* Mixer initialization */
 	mixer_reset();
+#ifdef INSTRUMENT_BANK
+	clear_instruments();
+#endif
+
+	/* Deadline monitor and adaptive quality initialization (budget of one sample) */
+	deadline_reset();
+	quality_reset();
 
 	/* Sampling timer initialization */
 	timer_init(SAMPLE_RATE);
 
+#ifdef PLAYER_OUTPUT
+	/* Render until end of stream or limits (the render session restart the engine) */
+#ifdef PACED_OUTPUT
+	const uint32_t block_size = PLAYER_PACED_BLOCK_SIZE;
+#else
+	const uint32_t block_size = PLAYER_BLOCK_SIZE;
+#endif
+	const Player_config_t config = {
+		block_size, PLAYER_RING_DEPTH, PLAYER_HIGH_WATERMARK, PLAYER_LOW_WATERMARK,
+		{ (PLAYER_MAX_DURATION_MS * SAMPLE_RATE) / 1000, PLAYER_MAX_LOOPS }
+	};
+	Player_stats_t stats;
+#if defined(FANOUT_OUTPUT)
+	/* Output sink as rendered, 16 bits WAV file and IMA-ADPCM WAV file (encoded by the sink, in its output thread) */
+	Sink_t wav_sink, adpcm_sink;
+	const Sink_format_t wav_format = { SAMPLE_RATE, 1, 16 };
+	const Sink_format_t adpcm_format = { SAMPLE_RATE, 1, 8 };
+	if (!sink_open(&wav_sink, SINK_WAV, FANOUT_WAV_FILENAME, &wav_format)) {
+		perror("Unable to open WAV sink");
+		stop_timer_dac();
+		return 1;
+	}
+	if (!sink_open(&adpcm_sink, SINK_ADPCM, FANOUT_ADPCM_FILENAME, &adpcm_format)) {
+		perror("Unable to open ADPCM sink");
+		sink_close(&wav_sink);
+		stop_timer_dac();
+		return 1;
+	}
+	Fanout_output_t outputs[] = {
+		{ .format = &fanout_format_u8, .sink = &output_sink },
+		{ .format = &fanout_format_s16, .sink = &wav_sink },
+		{ .format = &fanout_format_u8, .sink = &adpcm_sink }
+	};
+	uint8_t success = fanout_run(&config, outputs, sizeof(outputs) / sizeof(outputs[0]), &stats);
+	sink_close(&wav_sink);
+	sink_close(&adpcm_sink);
+	fanout_print_stats(outputs, sizeof(outputs) / sizeof(outputs[0]));
+#elif defined(THREADED_OUTPUT)
+	uint8_t success = player_run_threaded(&config, &stats);
+#elif defined(PACED_OUTPUT)
+	uint8_t success = player_run_paced(&config, &stats);
+#else
+	uint8_t success = player_run_offline(&config, &stats);
+#endif
+	stop_timer_dac();
+	player_print_stats(&stats);
+	profile_dump();
+	deadline_dump();
+	quality_dump();
+	return success ? 0 : 1;
+#else
 	/* Infinite loop */
 	tracker_fetch_execute();
 	for (;;) {
 #ifdef EMULATE_TIMER
 		sampling_fnct();
+		if (tracker_end_of_stream)
+			break;
 #endif
 	}
 
+#ifdef EMULATE_TIMER
+	/* End of stream */
+	stop_timer_dac();
+	puts("END OF STREAM\n");
+	profile_dump();
+	deadline_dump();
+	quality_dump();
+#endif
+#endif
+
 	return 0;
 }
@@ -25,13 +25,110 @@
 #include "envelope.h"     // For ADSR envelope name
 #include "oscillator.h"   // For Waveform name
 #include "mixer.h"        // For channel name
+#include "profile.h"      // For ISR profiling
+#include "deadline.h"     // For deadline monitor
+#include "quality.h"      // For adaptive quality
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool
+
+#if defined(WIDE_OUTPUT) && !defined(PORT_WIDE_OUTPUT)
+#error "This port doesn't support 16 bits / float output (OUTPUT_S16 / OUTPUT_F32)"
+#endif
+#if OUTPUT_CHANNELS > 1 && !defined(PORT_MULTICHANNEL_OUTPUT)
+#error "This port doesn't support multichannel output (OUTPUT_CHANNELS > 1)"
+#endif
 
 /* Mixer object */
 volatile Mixer_t mixer;
 
-inline int16_t map_sample(int16_t x, int16_t in_min, int16_t in_max, int16_t out_min, int16_t out_max) {
-  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+#ifdef STEM_OUTPUT
+/* Post-gain sample of each channel */
+uint8_t mixer_stems[NUMBERS_OF_CHANNEL];
+#endif
+
+#ifdef INSTRUMENT_BANK
+/* Instrument bank */
+volatile Instrument_t instruments[INSTRUMENTS];
+
+void setup_instrument(uint8_t instrument, uint8_t waveform, uint8_t duty, uint8_t volume, uint8_t envelope) {
+	if (instrument >= INSTRUMENTS || envelope > ADSR_ENVELOPES) // Overflow check
+		return;
+	instruments[instrument].waveform = waveform;
+	instruments[instrument].duty = duty;
+	instruments[instrument].volume = volume;
+	instruments[instrument].envelope = envelope;
+}
+
+void clear_instruments(void) {
+	for (uint8_t instrument = 0; instrument < INSTRUMENTS; ++instrument)
+		setup_instrument(instrument, WF_NONE, 127, 0, ADSR_NONE);
 }
+#endif
+
+#if defined(SCALE_GAIN_TABLE) || defined(RENDER_API)
+/* Scale of a gain step (middle of the scale values of the step, half a step of error at most) */
+#define GAIN_STEP_SCALE(step) (((step) << GAIN_TABLE_SHIFT) + (1 << (GAIN_TABLE_SHIFT - 1)))
+
+/* Gain table rows, generated at compile time */
+#define GAIN_1(v, s) (uint8_t)(((v) * GAIN_STEP_SCALE(s)) >> 8)
+#define GAIN_4(v, s) GAIN_1(v, s), GAIN_1(v + 1, s), GAIN_1(v + 2, s), GAIN_1(v + 3, s)
+#define GAIN_16(v, s) GAIN_4(v, s), GAIN_4(v + 4, s), GAIN_4(v + 8, s), GAIN_4(v + 12, s)
+#define GAIN_64(v, s) GAIN_16(v, s), GAIN_16(v + 16, s), GAIN_16(v + 32, s), GAIN_16(v + 48, s)
+#define GAIN_ROW(s) GAIN_64(0, s), GAIN_64(64, s), GAIN_64(128, s), GAIN_64(192, s)
+#define GAIN_ROWS_4(s) GAIN_ROW(s), GAIN_ROW(s + 1), GAIN_ROW(s + 2), GAIN_ROW(s + 3)
+
+/* Gain table */
+const uint8_t gain_table[GAIN_TABLE_STEPS * 256] PROGMEM = {
+	GAIN_ROWS_4(0), GAIN_ROWS_4(4), GAIN_ROWS_4(8), GAIN_ROWS_4(12)
+#if GAIN_TABLE_STEPS == 32
+	, GAIN_ROWS_4(16), GAIN_ROWS_4(20), GAIN_ROWS_4(24), GAIN_ROWS_4(28)
+#endif
+};
+#endif
+
+#if OUTPUT_CHANNELS > 1
+/* Equal power pan law, 255 x sin(i / 256 x pi / 2) */
+static const uint8_t pan_law[257] PROGMEM = {
+	0, 2, 3, 5, 6, 8, 9, 11, 13, 14, 16, 17, 19, 20, 22, 23,
+	25, 27, 28, 30, 31, 33, 34, 36, 37, 39, 41, 42, 44, 45, 47, 48,
+	50, 51, 53, 54, 56, 57, 59, 60, 62, 63, 65, 67, 68, 70, 71, 73,
+	74, 76, 77, 79, 80, 81, 83, 84, 86, 87, 89, 90, 92, 93, 95, 96,
+	98, 99, 100, 102, 103, 105, 106, 108, 109, 110, 112, 113, 115, 116, 117, 119,
+	120, 122, 123, 124, 126, 127, 128, 130, 131, 132, 134, 135, 136, 138, 139, 140,
+	142, 143, 144, 146, 147, 148, 149, 151, 152, 153, 154, 156, 157, 158, 159, 161,
+	162, 163, 164, 165, 167, 168, 169, 170, 171, 172, 174, 175, 176, 177, 178, 179,
+	180, 181, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196,
+	197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 208, 209, 210, 211,
+	212, 213, 214, 215, 215, 216, 217, 218, 219, 220, 220, 221, 222, 223, 223, 224,
+	225, 226, 226, 227, 228, 228, 229, 230, 231, 231, 232, 232, 233, 234, 234, 235,
+	236, 236, 237, 237, 238, 238, 239, 240, 240, 241, 241, 242, 242, 243, 243, 244,
+	244, 244, 245, 245, 246, 246, 247, 247, 247, 248, 248, 248, 249, 249, 249, 250,
+	250, 250, 251, 251, 251, 252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 254,
+	254, 254, 254, 254, 254, 254, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255
+};
+
+void mixer_update_pan_gains(uint8_t channel) {
+	volatile Channel_t *source = &(mixer.channels[channel]);
+
+	/* Position between the two nearest outputs (8 bits of fraction, 128 is the exact center, 255 the last output) */
+	uint8_t pan = source->pan;
+	uint16_t position = (pan <= 128) ? pan : 128 + ((pan - 128) * 128 + 63) / 127;
+	position *= OUTPUT_CHANNELS - 1;
+	uint8_t output = position >> 8;
+	uint16_t fraction = position & 0xFF;
+	if (output == OUTPUT_CHANNELS - 1) { // Last output
+		output = OUTPUT_CHANNELS - 2;
+		fraction = 256;
+	}
+
+	/* Volume x pan law of each output */
+	for (uint8_t i = 0; i < OUTPUT_CHANNELS; ++i)
+		source->pan_gains[i] = 0;
+	source->pan_gains[output] = ((uint16_t)source->volume * pgm_read_byte(pan_law + 256 - fraction) + 127) / 255;
+	source->pan_gains[output + 1] = ((uint16_t)source->volume * pgm_read_byte(pan_law + fraction) + 127) / 255;
+}
+#endif
 
 /* Sampling ISR */
 TIMER_ISR_FUNCTION {
@@ -39,30 +136,120 @@ TIMER_ISR_FUNCTION {
 	/* Re-arm sampling timer */
 	rearm_sampling_timer();
 
+	/* Compute sample */
+#if defined(OUTPUT_S16)
+	int16_t frame[OUTPUT_CHANNELS];
+	mixer_render_frame_s16(frame);
+#elif defined(OUTPUT_F32)
+	float frame[OUTPUT_CHANNELS];
+	mixer_render_frame_f32(frame);
+#else
+	uint8_t sample = mixer_render_sample();
+#endif
+#ifdef EMULATE_TIMER
+	if (tracker_end_of_stream)
+		return; // Not part of the song
+#endif
+
+	/* Output sample of each output */
+	for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output) {
+#ifdef WIDE_OUTPUT
+		output_sample_dac(frame[output]);
+#else
+		output_sample_dac(sample); // 8 bits output is mono
+#endif
+	}
+	profile_output();
+}
+
+/* Get envelope sample of a channel */
+static inline uint8_t get_channel_envelope(uint8_t channel) {
+#ifdef ADAPTIVE_QUALITY
+	/* Control rate : one update every QUALITY_CONTROL_RATE samples (staggered between channels), hold the last sample between updates */
+	if (quality.level >= QUALITY_CONTROL_RATE_ENVELOPES && ((quality.control_phase + channel) & (QUALITY_CONTROL_RATE - 1)) != 0)
+		return quality.envelopes[channel];
+
+	/* Process every sample since the last update of this channel */
+	envelope_ticks = quality.control_phase - quality.envelope_phases[channel];
+	quality.envelope_phases[channel] = quality.control_phase;
+	quality.envelopes[channel] = get_envelope_sample(&(mixer.channels[channel].envelope));
+	envelope_ticks = 1;
+	return quality.envelopes[channel];
+#else
+	return get_envelope_sample(&(mixer.channels[channel].envelope));
+#endif
+}
+
+/* Start of sample hooks and tempo tick (tracker opcodes and modulators) */
+static inline void begin_sample(void) {
+
 	/* Handle SubTimer (for tempo) */
+	deadline_begin_sample();
+	quality_begin_sample();
+	profile_begin_sample();
 	tracker_tempo_tick();
+	modulation_sample();
+	profile_lap(PROFILE_TEMPO);
+	quality_check();
+}
+
+/* End of sample hooks */
+static inline void end_sample(void) {
+	profile_end_sample();
+	quality_end_sample();
+	deadline_end_sample();
+}
+
+/* Get waveform and envelope samples of a voice (front end of every render path), return 0 if the voice is muted */
+static inline uint8_t render_voice(uint8_t channel, uint8_t *value, uint8_t *adsr) {
+#ifdef ADAPTIVE_QUALITY
+	/* Skip muted voices */
+	if (quality.dropped[channel])
+		return 0;
+#endif
+
+	/* Get sample from waveform */
+	*value = get_waveform_sample(&(mixer.channels[channel].oscillator));
+	prepare_next_sample(&(mixer.channels[channel].oscillator));
+#ifdef ADAPTIVE_QUALITY
+	noise_hold = (quality.level >= QUALITY_SHARED_NOISE); // Noise regenerated by the first voice only
+#endif
+	profile_lap(PROFILE_OSCILLATORS);
+
+	/* Get envelope sample from ADSR */
+	*adsr = get_channel_envelope(channel);
+	profile_lap(PROFILE_ENVELOPES);
+	return 1;
+}
+
+uint8_t mixer_render_sample(void) {
+	begin_sample();
 
 	/* Final output sample (signed) */
 	int16_t sample = 0;
 
 	/* For each channels of mixer */
-	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
-
-		/* Get sample from waveform */
-		uint8_t value = get_waveform_sample(&(mixer.channels[channel].oscillator));
-		prepare_next_sample(&(mixer.channels[channel].oscillator));
-
-		/* Get envelope sample from ADSR */
-		uint8_t adsr = get_envelope_sample(&(mixer.channels[channel].envelope));
+	for (uint8_t channel = 0; channel < MIXER_VOICES; ++channel) {
+		uint8_t value, adsr;
+		if (!render_voice(channel, &value, &adsr)) {
+#ifdef STEM_OUTPUT
+			mixer_stems[channel] = 127;
+#endif
+			continue;
+		}
 
 		/* Scale the value according the ADSR volume */
 		value = scale_value(value, adsr);
 
 		/* Scale the value according the channel volume */
 		value = scale_value(value, mixer.channels[channel].volume);
+#ifdef STEM_OUTPUT
+		mixer_stems[channel] = value;
+#endif
 
 		/* Mix channel value and output sample */
 		sample += (int16_t)value - 127; // Remove DC offset
+		profile_lap(PROFILE_MIXING);
 	}
 
 	/* Avoid clipping by mapping sample output */
@@ -71,12 +258,100 @@ TIMER_ISR_FUNCTION {
 	if(sample < 0) sample = 0;
 
 	/* Scale the sample according the global mixer volume */
-	sample = scale_value(sample, mixer.global_volume);
+	uint8_t output = scale_value(sample, mixer.global_volume);
+	end_sample();
+	return output;
+}
+
+#if defined(WIDE_OUTPUT) || defined(RENDER_API)
+/* Full scale of the wide sum (all channels at -128 x 255 x 255, global volume 255) */
+#define WIDE_FULL_SCALE (NUMBERS_OF_CHANNEL * 128ULL * 255 * 255 * 255)
+
+/* Gain of 16 bits output (sum x global volume to 16 bits with 8 bits of fraction, 32 bits fixed point) */
+#define WIDE_S16_GAIN ((32768ULL << 40) / WIDE_FULL_SCALE)
+
+/* Gain of float output */
+#define WIDE_F32_GAIN (1.0f / WIDE_FULL_SCALE)
+
+#ifdef OUTPUT_DITHER
+/* Dither generator (xorshift, independent of noise_seed) */
+static uint32_t dither_seed = 0x2545F491;
+#endif
 
-	/* Output sample */
-	output_sample_dac(sample);
+/* Compute next sample of all channels, sum of channels x combined gain (envelope x volume x pan law) of each output */
+static inline void render_wide_sums(int32_t *sums) {
+	begin_sample();
+
+	/* Sums of channels (signed) */
+	for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output)
+		sums[output] = 0;
+
+	/* For each channels of mixer */
+	for (uint8_t channel = 0; channel < MIXER_VOICES; ++channel) {
+		uint8_t value, adsr;
+		if (!render_voice(channel, &value, &adsr))
+			continue;
+
+		/* Scale the value (without DC offset) according the combined gain and mix */
+#if OUTPUT_CHANNELS > 1
+		int32_t voice = ((int16_t)value - 128) * (int16_t)adsr;
+		for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output)
+			sums[output] += voice * mixer.channels[channel].pan_gains[output];
+#else
+		sums[0] += ((int16_t)value - 128) * (int32_t)((uint16_t)adsr * mixer.channels[channel].volume);
+#endif
+		profile_lap(PROFILE_MIXING);
+	}
 }
 
+void mixer_render_frame_s16(int16_t *frame) {
+	int32_t sums[OUTPUT_CHANNELS];
+	render_wide_sums(sums);
+
+	for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output) {
+
+		/* Global volume and normalization, 8 bits of fraction */
+		int32_t sample = ((int64_t)sums[output] * mixer.global_volume * WIDE_S16_GAIN) >> 32;
+
+#ifdef OUTPUT_DITHER
+		/* TPDF dither (difference of two uniform values, +/- 1 LSB) */
+		dither_seed ^= dither_seed << 13;
+		dither_seed ^= dither_seed >> 17;
+		dither_seed ^= dither_seed << 5;
+		sample += (int16_t)(dither_seed & 0xFF) - (int16_t)((dither_seed >> 8) & 0xFF);
+#endif
+
+		/* Round to 16 bits */
+		sample = (sample + 128) >> 8;
+		if (sample > 32767) sample = 32767;
+		if (sample < -32768) sample = -32768;
+		frame[output] = sample;
+	}
+	end_sample();
+}
+
+void mixer_render_frame_f32(float *frame) {
+	int32_t sums[OUTPUT_CHANNELS];
+	render_wide_sums(sums);
+
+	for (uint8_t output = 0; output < OUTPUT_CHANNELS; ++output)
+		frame[output] = (float)sums[output] * (mixer.global_volume * WIDE_F32_GAIN);
+	end_sample();
+}
+
+int16_t mixer_render_sample_s16(void) {
+	int16_t frame[OUTPUT_CHANNELS];
+	mixer_render_frame_s16(frame);
+	return frame[0];
+}
+
+float mixer_render_sample_f32(void) {
+	float frame[OUTPUT_CHANNELS];
+	mixer_render_frame_f32(frame);
+	return frame[0];
+}
+#endif
+
 void mixer_reset(void) {
 
 	/* Reset global volume */
@@ -87,6 +362,10 @@ void mixer_reset(void) {
 
 		/* Reset channel and oscillator */
 		mixer.channels[channel].volume = 0;
+#if OUTPUT_CHANNELS > 1
+		mixer.channels[channel].pan = 128;
+		mixer_update_pan_gains(channel);
+#endif
 		
 		mixer.channels[channel].envelope.type = ADSR_NONE;
 		reset_envelope(&(mixer.channels[channel].envelope), ENV_ATTACK);
@@ -97,4 +376,12 @@ void mixer_reset(void) {
 		mixer.channels[channel].oscillator.tunning_word = 0;
 		mixer.channels[channel].oscillator.phase_accumulator = 0;
 	}
+
+	/* Clear modulators */
+	modulation_reset();
+
+#ifdef VOICE_POOL
+	/* Free every voice */
+	voice_reset();
+#endif
 }
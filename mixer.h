@@ -9,6 +9,9 @@
  * This functions bundle handle all stuff related to channels mixing.\n
  * My implementation of sound mixing is based on signed values addition with scaling.\n
  * For platform with unsigned sound output the scaling function can be truncated to unsigned output.\n
+ * With OUTPUT_CHANNELS > 1 each channel is positioned on the output bus by its pan (SET_PAN opcode) : the volume x pan law gain
+ * of each output is updated on volume / pan change, so each output cost one multiply-add per channel in the wide output path.
+ * The 8 bits output path stay mono (same sample on each output).\n
  * \n
  * Please report bug to <skywodd at gmail.com>
  *
@@ -40,6 +43,10 @@ typedef struct {
 	Oscillator_t oscillator;
 	Envelope_t envelope;
 	uint8_t volume;
+#if OUTPUT_CHANNELS > 1
+	uint8_t pan;                        // Position on the output bus (0 = first output, 255 = last output)
+	uint8_t pan_gains[OUTPUT_CHANNELS]; // Volume x pan law of each output (updated on volume / pan change)
+#endif
 } Channel_t;
 
 /**
@@ -50,6 +57,18 @@ typedef struct {
 	uint8_t global_volume;
 } Mixer_t;
 
+#ifdef INSTRUMENT_BANK
+/**
+ * Instrument structure (channel settings applied by one SET_INSTRUMENT opcode, the ADSR envelope is resolved by setup_adsr_envelope())
+ */
+typedef struct {
+	uint8_t waveform;
+	uint8_t duty;
+	uint8_t volume;
+	uint8_t envelope; // ADSR envelope type
+} Instrument_t;
+#endif
+
 /**
  * Channel enumeration
  */
@@ -77,6 +96,70 @@ typedef enum {
  */
 extern volatile Mixer_t mixer;
 
+#ifdef INSTRUMENT_BANK
+/**
+ * Instrument bank
+ */
+extern volatile Instrument_t instruments[INSTRUMENTS];
+#endif
+
+#ifdef STEM_OUTPUT
+/**
+ * Post-gain sample of each channel of the last mixer_render_sample() call (8 bits unsigned, before mix),
+ * the contribution of a channel to the mix is its stem - 127
+ */
+extern uint8_t mixer_stems[NUMBERS_OF_CHANNEL];
+#endif
+
+/**
+ * Multiply two 8 bits values and keep the high byte of the product, using shifts and adds only
+ *
+ * @param value Value to scale
+ * @param scale Scaling value
+ * @return (value * scale) >> 8 (exact)
+ * @remarks For MCU without hardware multiplier (8 iterations instead of a 16 x 16 bits software multiply)
+ */
+inline uint8_t scale_shift_add(uint8_t value, uint8_t scale) {
+	uint16_t product = 0;
+	uint16_t addend = value;
+	for (; scale; scale >>= 1, addend <<= 1)
+		if (scale & 1)
+			product += addend;
+	return product >> 8;
+}
+
+#if defined(SCALE_GAIN_TABLE) || defined(RENDER_API)
+/**
+ * Gain table : (value * step scale) >> 8 for each gain step and each value (see mixer.c)
+ */
+extern const uint8_t gain_table[GAIN_TABLE_STEPS * 256] PROGMEM;
+
+/**
+ * Multiply two 8 bits values and keep the high byte of the product, using the gain table
+ *
+ * @param value Value to scale
+ * @param scale Scaling value, quantized to GAIN_TABLE_STEPS steps
+ * @return (value * step scale) >> 8
+ * @remarks For MCU without hardware multiplier (one PROGMEM read), the scale is quantized
+ */
+inline uint8_t scale_gain_table(uint8_t value, uint8_t scale) {
+	return pgm_read_byte(gain_table + ((uint16_t)(scale >> GAIN_TABLE_SHIFT) << 8) + value);
+}
+#endif
+
+/**
+ * High byte of value x scale, according to the gain stage configuration
+ */
+#if defined(SCALE_GAIN_TABLE) && defined(SCALE_SHIFT_ADD)
+#error "SCALE_GAIN_TABLE and SCALE_SHIFT_ADD cannot be used together"
+#elif defined(SCALE_GAIN_TABLE)
+#define SCALE_PRODUCT(value, scale) scale_gain_table(value, scale)
+#elif defined(SCALE_SHIFT_ADD)
+#define SCALE_PRODUCT(value, scale) scale_shift_add(value, scale)
+#else
+#define SCALE_PRODUCT(value, scale) (((value) * (scale)) >> 8)
+#endif
+
 /**
  * Scale value according to another one
  *
@@ -84,6 +167,7 @@ extern volatile Mixer_t mixer;
  * @param scale Scaling value
  * @return Scaled value
  * @remarks Undefine SCALE_WITH_AUTO_OFFSET to truncate the ouput to unsigned value
+ * @remarks Value and scale must be under 256 with SCALE_SHIFT_ADD or SCALE_GAIN_TABLE
  */
 inline uint8_t scale_value(uint16_t value, uint16_t scale) {
 #ifdef SCALE_WITH_AUTO_OFFSET
@@ -91,20 +175,75 @@ inline uint8_t scale_value(uint16_t value, uint16_t scale) {
 		return 0;
 	if(scale == 0)
 		return value / 2;
-	uint8_t new_value = ((value * scale) >> 8) + 1;
+	uint8_t new_value = SCALE_PRODUCT(value, scale) + 1;
 	return new_value + ((value - new_value) / 2);
 #else
 	if(value == 0 || scale == 0)
 		return 0;
-	return ((value * scale) >> 8) + 1;
+	return SCALE_PRODUCT(value, scale) + 1;
 #endif
 }
 
+/**
+ * Map a value from an input range to an output range
+ *
+ * @param x Value to map
+ * @param in_min Lower bound of input range
+ * @param in_max Upper bound of input range
+ * @param out_min Lower bound of output range
+ * @param out_max Upper bound of output range
+ * @return Mapped value
+ */
+inline int16_t map_sample(int16_t x, int16_t in_min, int16_t in_max, int16_t out_min, int16_t out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
 /**
  * Reset mixer
  */
 void mixer_reset(void);
 
+/**
+ * Compute next output sample (handle tempo tick, oscillators, envelopes and mixing)
+ *
+ * @return Output sample (8 bits, unsigned)
+ * @remarks Called by the sampling ISR, can also be called directly for offline rendering
+ */
+uint8_t mixer_render_sample(void);
+
+#if defined(WIDE_OUTPUT) || defined(RENDER_API)
+/**
+ * Compute next output frame, wide output path (16 bits signed)
+ *
+ * @param frame Output frame (OUTPUT_CHANNELS samples, 16 bits, signed, TPDF dither if OUTPUT_DITHER is defined)
+ * @remarks Each channel is scaled once by its combined gain (envelope x volume, or envelope x volume x pan law of each output)
+ * and summed on 32 bits, the global volume and the normalization (no clipping) are applied once to each sum
+ */
+void mixer_render_frame_s16(int16_t *frame);
+
+/**
+ * Compute next output frame, wide output path (float)
+ *
+ * @param frame Output frame (OUTPUT_CHANNELS samples, float32, -1.0 to 1.0)
+ * @remarks Same mixing as mixer_render_frame_s16()
+ */
+void mixer_render_frame_f32(float *frame);
+
+/**
+ * Compute next output sample, wide output path (16 bits signed)
+ *
+ * @return Output sample of the first output (16 bits, signed), see mixer_render_frame_s16()
+ */
+int16_t mixer_render_sample_s16(void);
+
+/**
+ * Compute next output sample, wide output path (float)
+ *
+ * @return Output sample of the first output (float32, -1.0 to 1.0), see mixer_render_frame_f32()
+ */
+float mixer_render_sample_f32(void);
+#endif
+
 /**
  * Set waveform of specified channel
  *
@@ -112,9 +251,20 @@ void mixer_reset(void);
  * @param waveform Waveform to set
  */
 inline void mixer_set_wave(uint8_t channel, uint8_t waveform) {
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
 	mixer.channels[channel].oscillator.waveform = waveform;
 }
 
+#if OUTPUT_CHANNELS > 1
+/**
+ * Update volume x pan law gains of specified channel (equal power law between the two nearest outputs)
+ *
+ * @param channel Channel to update
+ */
+void mixer_update_pan_gains(uint8_t channel);
+#endif
+
 /**
  * Set volume of specified channel
  *
@@ -122,7 +272,31 @@ inline void mixer_set_wave(uint8_t channel, uint8_t waveform) {
  * @param volume Volume to set
  */
 inline void mixer_set_volume(uint8_t channel, uint8_t volume) {
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
 	mixer.channels[channel].volume = volume;
+#if OUTPUT_CHANNELS > 1
+	mixer_update_pan_gains(channel);
+#endif
+}
+
+/**
+ * Set position of specified channel on the output bus
+ *
+ * @param channel Channel to set
+ * @param pan Position to set (0 = first output, 128 = center, 255 = last output)
+ * @remarks No effect on mono output (OUTPUT_CHANNELS = 1)
+ */
+inline void mixer_set_pan(uint8_t channel, uint8_t pan) {
+#if OUTPUT_CHANNELS > 1
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
+	mixer.channels[channel].pan = pan;
+	mixer_update_pan_gains(channel);
+#else
+	(void)channel;
+	(void)pan;
+#endif
 }
 
 /**
@@ -141,6 +315,8 @@ inline void mixer_set_global_volume(uint8_t volume) {
  * @param frequency Frequency of note ON event
  */
 inline void mixer_note_on(uint8_t channel, uint8_t frequency) {
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
 	set_oscillator_tunning_word(&(mixer.channels[channel].oscillator), frequency);
 	reset_envelope(&(mixer.channels[channel].envelope), ENV_ATTACK);
 }
@@ -151,6 +327,8 @@ inline void mixer_note_on(uint8_t channel, uint8_t frequency) {
  * @param channel Channel to set
  */
 inline void mixer_note_off(uint8_t channel) {
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
 	if (mixer.channels[channel].envelope.type == ADSR_NONE) {
 		set_oscillator_tunning_word(&(mixer.channels[channel].oscillator), 0);
 	} else {
@@ -165,6 +343,8 @@ inline void mixer_note_off(uint8_t channel) {
  * @param channel_2 Channel to sync with
  */
 inline void mixer_sync_oscillators(uint8_t channel_1, uint8_t channel_2) {
+	if (channel_1 >= NUMBERS_OF_CHANNEL || channel_2 >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
 	mixer.channels[channel_1].oscillator.phase_accumulator = mixer.channels[channel_2].oscillator.phase_accumulator;
 }
 
@@ -174,6 +354,8 @@ inline void mixer_sync_oscillators(uint8_t channel_1, uint8_t channel_2) {
  * @param channel Channel of oscillator to reset
  */
 inline void mixer_reset_oscillator(uint8_t channel) {
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
 	mixer.channels[channel].oscillator.phase_accumulator = 0;
 }
 
@@ -184,7 +366,7 @@ inline void mixer_reset_oscillator(uint8_t channel) {
  * @param envelope Envelope to set
  */
 inline void mixer_set_adsr(uint8_t channel, uint8_t envelope) {
-	if (envelope > NUMBERS_OF_CHANNEL + 1)
+	if (channel >= NUMBERS_OF_CHANNEL || envelope > ADSR_ENVELOPES) // Overflow check
 		return;
 	mixer.channels[channel].envelope.type = envelope;
 	reset_envelope(&(mixer.channels[channel].envelope), ENV_ATTACK);
@@ -198,8 +380,44 @@ inline void mixer_set_adsr(uint8_t channel, uint8_t envelope) {
  * @param duty Duty value to set
  */
 inline void mixer_set_duty(uint8_t channel, uint8_t duty) {
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
 	mixer.channels[channel].oscillator.duty = duty;
 }
 
+#ifdef INSTRUMENT_BANK
+/**
+ * Setup instrument
+ *
+ * @param instrument Instrument index
+ * @param waveform Waveform
+ * @param duty Square wave duty
+ * @param volume Channel volume
+ * @param envelope ADSR envelope type
+ */
+void setup_instrument(uint8_t instrument, uint8_t waveform, uint8_t duty, uint8_t volume, uint8_t envelope);
+
+/**
+ * Clear all instruments (no waveform, duty 127, volume 0, no ADSR envelope)
+ */
+void clear_instruments(void);
+
+/**
+ * Apply an instrument to specified channel (waveform, duty, volume and ADSR envelope)
+ *
+ * @param channel Channel to set
+ * @param instrument Instrument index (ignored if out of range)
+ */
+inline void mixer_set_instrument(uint8_t channel, uint8_t instrument) {
+	if (channel >= NUMBERS_OF_CHANNEL || instrument >= INSTRUMENTS) // Overflow check
+		return;
+	volatile Instrument_t *source = &(instruments[instrument]);
+	mixer.channels[channel].oscillator.waveform = source->waveform;
+	mixer.channels[channel].oscillator.duty = source->duty;
+	mixer_set_volume(channel, source->volume);
+	mixer_set_adsr(channel, source->envelope);
+}
+#endif
+
 
 #endif // _MIXER_H_
@@ -0,0 +1,224 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For frequency lookup table
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+#include "modulation.h"   // For modulation structure
+#include "voice.h"        // For voice pool
+
+#ifdef MODULATION
+
+/* Modulation object */
+volatile Modulation_t modulation;
+
+/* LFO quarter period, 127 x sin(i / 64 x pi / 2) */
+static const uint8_t lfo_table[65] PROGMEM = {
+	0, 3, 6, 9, 12, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46,
+	49, 51, 54, 57, 60, 63, 65, 68, 71, 73, 76, 78, 81, 83, 85, 88,
+	90, 92, 94, 96, 98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+	117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+	127
+};
+
+/* LFO value of a phase (-127 to 127, one period every 256 phase steps) */
+static inline int8_t get_lfo(uint8_t phase) {
+	uint8_t index = phase & 0x3F;
+	if (phase & 0x40) // Second and fourth quarters are mirrored
+		index = 64 - index;
+	int8_t value = pgm_read_byte(lfo_table + index);
+	return (phase & 0x80) ? -value : value;
+}
+
+/* Tuning word (8.8 fixed point) of an arpeggio step of a note */
+static inline uint16_t get_note_pitch(uint8_t note, uint8_t arpeggio, uint8_t step) {
+	if (step == 1)
+		note += arpeggio >> 4;
+	else if (step == 2)
+		note += arpeggio & 0x0F;
+	if (note > 127)
+		note = 127;
+	return (uint16_t)pgm_read_byte(frequency_table + note) << 8;
+}
+
+/* Take the tuning word and duty set by opcodes since the last update as base of the modulators */
+static inline void sync_base(uint8_t channel) {
+	volatile Modulator_t *modulator = &(modulation.channels[channel]);
+	volatile Oscillator_t *oscillator = &(mixer.channels[channel].oscillator);
+	if (oscillator->tunning_word != modulator->tuning) { // Note off, note on without note
+		modulator->note = MODULATION_NO_NOTE;
+		modulator->pitch = modulator->target = (uint16_t)oscillator->tunning_word << 8;
+		modulator->tuning = oscillator->tunning_word;
+	}
+	if (oscillator->duty != modulator->duty_applied) // SET_DUTY
+		modulator->duty = modulator->duty_applied = oscillator->duty;
+}
+
+void modulation_apply_settings(uint8_t channel, volatile Modulator_settings_t *settings) {
+	if (channel >= NUMBERS_OF_CHANNEL) // Overflow check
+		return;
+	volatile Modulator_t *modulator = &(modulation.channels[channel]);
+	volatile Oscillator_t *oscillator = &(mixer.channels[channel].oscillator);
+	modulator->settings = *settings;
+	modulator->pitch = modulator->target = 0; // No portamento from the previous note
+	modulator->note = MODULATION_NO_NOTE;
+	modulator->tuning = oscillator->tunning_word;
+	modulator->duty = modulator->duty_applied = oscillator->duty;
+	modulator->vibrato_phase = 0;
+	modulator->pwm_phase = 0;
+	modulator->arpeggio_step = 0;
+	modulator->arpeggio_counter = 0;
+}
+
+void modulation_reset(void) {
+	Modulator_settings_t settings = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel)
+		modulation_apply_settings(channel, &settings);
+	modulation.phase = 0;
+}
+
+/* Update modulators of a channel */
+static inline void update_channel(uint8_t channel) {
+	volatile Modulator_t *modulator = &(modulation.channels[channel]);
+	volatile Modulator_settings_t *settings = &(modulator->settings);
+	volatile Channel_t *source = &(mixer.channels[channel]);
+	sync_base(channel);
+
+	/* Arpeggio : next step */
+	if (settings->arpeggio && modulator->note != MODULATION_NO_NOTE && ++(modulator->arpeggio_counter) >= settings->arpeggio_speed) {
+		modulator->arpeggio_counter = 0;
+		modulator->arpeggio_step = (modulator->arpeggio_step == 2) ? 0 : modulator->arpeggio_step + 1;
+		modulator->target = get_note_pitch(modulator->note, settings->arpeggio, modulator->arpeggio_step);
+	}
+
+	/* Portamento : slide to the target (at once without portamento) */
+	uint16_t pitch = modulator->pitch;
+	uint16_t target = modulator->target;
+	uint16_t step = (uint16_t)settings->portamento << 4;
+	if (pitch < target)
+		pitch = (step && target - pitch > step) ? pitch + step : target;
+	else if (pitch > target)
+		pitch = (step && pitch - target > step) ? pitch - step : target;
+	modulator->pitch = pitch;
+
+	/* Vibrato, round to 8 bits */
+	int32_t tuning = pitch;
+	if (settings->vibrato_depth) {
+		modulator->vibrato_phase += settings->vibrato_speed;
+		tuning += ((int32_t)pitch * settings->vibrato_depth * get_lfo(modulator->vibrato_phase)) >> 17;
+	}
+	tuning = (tuning + 128) >> 8;
+	if (tuning > 255)
+		tuning = 255;
+	source->oscillator.tunning_word = modulator->tuning = tuning;
+
+	/* PWM */
+	if (settings->pwm_depth) {
+		modulator->pwm_phase += settings->pwm_speed;
+		int16_t duty = modulator->duty + ((int16_t)settings->pwm_depth * get_lfo(modulator->pwm_phase)) / 127;
+		if (duty > 255) duty = 255;
+		if (duty < 0) duty = 0;
+		source->oscillator.duty = modulator->duty_applied = duty;
+	}
+
+	/* Volume slide */
+	if (settings->volume_slide) {
+		int16_t volume = source->volume + settings->volume_slide;
+		if (volume > 255) volume = 255;
+		if (volume < 0) volume = 0;
+		if (volume != source->volume)
+			mixer_set_volume(channel, volume);
+	}
+}
+
+void modulation_update(void) {
+	for (uint8_t channel = 0; channel < MIXER_VOICES; ++channel)
+		update_channel(channel);
+}
+
+void modulation_set_note(uint8_t channel, uint8_t note) {
+	if (channel >= NUMBERS_OF_CHANNEL)
+		return;
+	volatile Modulator_t *modulator = &(modulation.channels[channel]);
+	volatile Oscillator_t *oscillator = &(mixer.channels[channel].oscillator);
+
+	/* Tuning word of the note set by mixer_note_on(), restart vibrato and arpeggio */
+	modulator->note = note;
+	modulator->target = (uint16_t)oscillator->tunning_word << 8;
+	modulator->vibrato_phase = 0;
+	modulator->arpeggio_step = 0;
+	modulator->arpeggio_counter = 0;
+
+	/* Portamento : keep the tuning word of the last note, slide from it at next updates */
+	if (modulator->settings.portamento && modulator->pitch)
+		oscillator->tunning_word = modulator->tuning;
+	else
+		modulator->pitch = modulator->target;
+	modulator->tuning = oscillator->tunning_word;
+}
+
+void modulation_set_vibrato(uint8_t channel, uint8_t depth, uint8_t speed) {
+	if (channel >= NUMBERS_OF_CHANNEL)
+		return;
+	modulation.channels[channel].settings.vibrato_depth = depth;
+	modulation.channels[channel].settings.vibrato_speed = speed;
+}
+
+void modulation_set_arpeggio(uint8_t channel, uint8_t semitones, uint8_t speed) {
+	if (channel >= NUMBERS_OF_CHANNEL)
+		return;
+	volatile Modulator_t *modulator = &(modulation.channels[channel]);
+	sync_base(channel);
+	modulator->settings.arpeggio = semitones;
+	modulator->settings.arpeggio_speed = speed;
+	modulator->arpeggio_step = 0;
+	modulator->arpeggio_counter = 0;
+	if (modulator->note != MODULATION_NO_NOTE) // Back to the base note
+		modulator->target = get_note_pitch(modulator->note, 0, 0);
+}
+
+void modulation_set_portamento(uint8_t channel, uint8_t speed) {
+	if (channel >= NUMBERS_OF_CHANNEL)
+		return;
+	modulation.channels[channel].settings.portamento = speed;
+}
+
+void modulation_set_pwm(uint8_t channel, uint8_t depth, uint8_t speed) {
+	if (channel >= NUMBERS_OF_CHANNEL)
+		return;
+	volatile Modulator_t *modulator = &(modulation.channels[channel]);
+	sync_base(channel);
+	modulator->settings.pwm_depth = depth;
+	modulator->settings.pwm_speed = speed;
+	if (depth == 0) // Back to the base duty
+		mixer.channels[channel].oscillator.duty = modulator->duty_applied = modulator->duty;
+}
+
+void modulation_set_volume_slide(uint8_t channel, int8_t slide) {
+	if (channel >= NUMBERS_OF_CHANNEL)
+		return;
+	modulation.channels[channel].settings.volume_slide = slide;
+}
+
+#endif
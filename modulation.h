@@ -0,0 +1,187 @@
+/**
+ * @file modulation.h
+ * @brief Generic digital chiptune generator - Control rate modulators
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle drive the tuning word, duty and volume of each mixer channel by modulators,
+ * evaluated once every MODULATION_RATE samples (control rate), the values are held by the oscillators between two updates :\n
+ * - vibrato : sinus LFO on the tuning word (depth in 1/1024 of the tuning word at the LFO peak, up to a quarter of the tuning word)\n
+ * - arpeggio : the note cycle through note, note + x semitones, note + y semitones, one step every n updates\n
+ * - portamento : the tuning word slide from the last note to the new note (in 1/16 of tuning word per update)\n
+ * - PWM : sinus LFO on the square wave duty (depth in duty steps at the LFO peak)\n
+ * - volume slide : the channel volume is raised or lowered by a signed step per update (clamped to 0 to 255)\n
+ * The tuning word of a modulated note is computed on 8.8 bits fixed point, the oscillator get its rounded 8 bits value.
+ * A tuning word or a duty set by an opcode since the last update (note on without note, note off, SET_DUTY) become the base of the modulators.\n
+ * A channel without modulator is left untouched (same output as without MODULATION).\n
+ * With VOICE_POOL the modulators settings belong to the logical channels and are applied to their voice at each allocation (see voice.h).\n
+ * When MODULATION is not defined every modulation call expand to nothing (zero overhead).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define MODULATION in common.h to use this functions bundle, include mixer.h before this file
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _MODULATION_H_
+#define _MODULATION_H_
+
+#ifdef MODULATION
+
+/**
+ * No base note (tuning word set without note)
+ */
+#define MODULATION_NO_NOTE 0xFF
+
+/**
+ * Modulators settings structure (set by the extended opcodes, 0 = modulator off)
+ */
+typedef struct {
+	uint8_t vibrato_depth;  // Vibrato depth (1/1024 of the tuning word at the LFO peak)
+	uint8_t vibrato_speed;  // Vibrato LFO phase increment per update (256 = one period)
+	uint8_t arpeggio;       // Arpeggio offsets in semitones (high nibble : second step, low nibble : third step)
+	uint8_t arpeggio_speed; // Number of updates per arpeggio step (0 = 1)
+	uint8_t portamento;     // Portamento speed (1/16 of tuning word per update)
+	uint8_t pwm_depth;      // PWM depth (duty steps at the LFO peak)
+	uint8_t pwm_speed;      // PWM LFO phase increment per update
+	int8_t volume_slide;    // Volume step per update
+} Modulator_settings_t;
+
+/**
+ * Modulators structure of a mixer channel
+ */
+typedef struct {
+	Modulator_settings_t settings;
+	uint16_t pitch;           // Current tuning word (8.8 fixed point, portamento)
+	uint16_t target;          // Tuning word of the note (8.8 fixed point)
+	uint8_t note;             // Base note (MODULATION_NO_NOTE if none)
+	uint8_t tuning;           // Tuning word written by the last update
+	uint8_t duty;             // Base duty (PWM)
+	uint8_t duty_applied;     // Duty written by the last update
+	uint8_t vibrato_phase;    // Vibrato LFO phase
+	uint8_t pwm_phase;        // PWM LFO phase
+	uint8_t arpeggio_step;    // Current arpeggio step (0 to 2)
+	uint8_t arpeggio_counter; // Updates since the last arpeggio step
+} Modulator_t;
+
+/**
+ * Modulation structure
+ */
+typedef struct {
+	Modulator_t channels[NUMBERS_OF_CHANNEL];
+	uint8_t phase; // Sample counter (update every MODULATION_RATE samples)
+} Modulation_t;
+
+/**
+ * Modulation object
+ */
+extern volatile Modulation_t modulation;
+
+/**
+ * Reset modulators of every channel (no modulator, no base note)
+ *
+ * @remarks Called by mixer_reset()
+ */
+void modulation_reset(void);
+
+/**
+ * Reset modulators of specified channel and apply settings
+ *
+ * @param channel Channel to set
+ * @param settings Modulators settings
+ * @remarks Used by the voice pool at each voice allocation
+ */
+void modulation_apply_settings(uint8_t channel, volatile Modulator_settings_t *settings);
+
+/**
+ * Update modulators of every channel (tuning word, duty and volume)
+ */
+void modulation_update(void);
+
+/**
+ * Count a sample, update modulators every MODULATION_RATE samples
+ *
+ * @remarks Called after the tempo tick of each sample
+ */
+inline void modulation_sample(void) {
+	if ((++(modulation.phase) & (MODULATION_RATE - 1)) == 0)
+		modulation_update();
+}
+
+/**
+ * Set base note of specified channel (call after mixer_note_on(), restart vibrato and arpeggio, start portamento)
+ *
+ * @param channel Channel to set
+ * @param note Note of note ON event
+ */
+void modulation_set_note(uint8_t channel, uint8_t note);
+
+/**
+ * Set vibrato of specified channel
+ *
+ * @param channel Channel to set
+ * @param depth Vibrato depth (1/1024 of the tuning word at the LFO peak, 0 = off)
+ * @param speed LFO phase increment per update (256 = one period)
+ */
+void modulation_set_vibrato(uint8_t channel, uint8_t depth, uint8_t speed);
+
+/**
+ * Set arpeggio of specified channel
+ *
+ * @param channel Channel to set
+ * @param semitones Offsets of second and third steps in semitones (high nibble and low nibble, 0 = off)
+ * @param speed Number of updates per step
+ */
+void modulation_set_arpeggio(uint8_t channel, uint8_t semitones, uint8_t speed);
+
+/**
+ * Set portamento of specified channel
+ *
+ * @param channel Channel to set
+ * @param speed Slide speed (1/16 of tuning word per update, 0 = off)
+ */
+void modulation_set_portamento(uint8_t channel, uint8_t speed);
+
+/**
+ * Set PWM of specified channel
+ *
+ * @param channel Channel to set
+ * @param depth PWM depth (duty steps at the LFO peak, 0 = off)
+ * @param speed LFO phase increment per update
+ */
+void modulation_set_pwm(uint8_t channel, uint8_t depth, uint8_t speed);
+
+/**
+ * Set volume slide of specified channel
+ *
+ * @param channel Channel to set
+ * @param slide Volume step per update (signed, 0 = off)
+ */
+void modulation_set_volume_slide(uint8_t channel, int8_t slide);
+
+#else
+
+/* Modulation disabled : no code at all */
+#define modulation_reset()
+#define modulation_sample()
+
+#endif
+
+#endif // _MODULATION_H_
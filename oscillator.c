@@ -46,15 +46,28 @@ static const uint8_t wave_sinus[256] PROGMEM = { 127, 130, 133, 136, 139, 143,
 		96, 99, 102, 105, 108, 111, 115, 118, 121, 124, 126
 };
 
+/* Noise seed power-on value */
+#define NOISE_SEED_INIT 0xB16B00B5
+
 /* Noise seed */
-volatile uint32_t noise_seed = 0xB16B00B5;
+volatile uint32_t noise_seed = NOISE_SEED_INIT;
+
+#ifdef ADAPTIVE_QUALITY
+/* Skip noise regeneration */
+volatile uint8_t noise_hold;
+#endif
 
 uint8_t get_waveform_sample(volatile Oscillator_t *oscillator) {
 
 	/* Compute noise */
-	noise_seed ^= (noise_seed << 13);
-	noise_seed ^= (noise_seed >> 17);
-	noise_seed ^= (noise_seed << 5);
+#ifdef ADAPTIVE_QUALITY
+	if (!noise_hold)
+#endif
+	{
+		noise_seed ^= (noise_seed << 13);
+		noise_seed ^= (noise_seed >> 17);
+		noise_seed ^= (noise_seed << 5);
+	}
 
 	/* For Sawtooth */
 	uint16_t tmp;
@@ -105,3 +118,7 @@ void prepare_next_sample(volatile Oscillator_t *oscillator) {
 	next_phase %= 256;
 	oscillator->phase_accumulator = next_phase;
 }
+
+void reset_noise_seed(void) {
+	noise_seed = NOISE_SEED_INIT;
+}
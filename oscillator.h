@@ -56,6 +56,18 @@ typedef struct {
 	uint8_t phase_accumulator;
 } Oscillator_t;
 
+/**
+ * Noise generator seed
+ */
+extern volatile uint32_t noise_seed;
+
+#ifdef ADAPTIVE_QUALITY
+/**
+ * Skip noise regeneration in get_waveform_sample() (shared noise, see quality.h)
+ */
+extern volatile uint8_t noise_hold;
+#endif
+
 /**
  * Set oscillator waveform of an Oscillator_t object
  *
@@ -101,4 +113,9 @@ uint8_t get_waveform_sample(volatile Oscillator_t *oscillator);
  */
 void prepare_next_sample(volatile Oscillator_t *oscillator);
 
+/**
+ * Reset noise generator seed to its power-on value
+ */
+void reset_noise_seed(void);
+
 #endif // _OSCILLATOR_H_
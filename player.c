@@ -0,0 +1,207 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For tracker commands
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+
+#ifdef PLAYER_OUTPUT
+
+#include <stdio.h>        // For statistics output
+#include <stdlib.h>       // For malloc
+#include <time.h>         // For clock_nanosleep
+#include <pthread.h>      // For render thread
+#include "ring.h"         // For ring structure
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool
+#include "render.h"       // For render session
+#include "player.h"       // For player structure
+
+/* Nanoseconds per second */
+#define NS_PER_SECOND 1000000000ULL
+
+/* Get monotonic time in nanoseconds */
+static inline uint64_t get_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+/* Threaded player context */
+typedef struct {
+	Ring_t ring;
+	Render_session_t session;
+} Player_context_t;
+
+/* Clear statistics */
+static void clear_stats(Player_stats_t *stats) {
+	stats->samples = 0;
+	stats->elapsed_ns = 0;
+	stats->underruns = 0;
+	stats->throttles = 0;
+	stats->max_fill = 0;
+	stats->periods = 0;
+	stats->deadline_misses = 0;
+	stats->max_lateness_ns = 0;
+	stats->status = RENDER_OK;
+}
+
+/* Render thread (producer) */
+static void *render_thread(void *arg) {
+	Player_context_t *context = arg;
+
+	while (context->session.status == RENDER_OK) {
+		uint8_t *block = ring_acquire_write(&(context->ring));
+		ring_commit_write(&(context->ring), render_samples(&(context->session), block, context->ring.block_size));
+	}
+
+	ring_close(&(context->ring));
+	return NULL;
+}
+
+uint8_t player_run_threaded(const Player_config_t *config, Player_stats_t *stats) {
+	Player_context_t context;
+	Ring_t *ring = &(context.ring);
+	pthread_t thread;
+
+	/* Start render thread */
+	clear_stats(stats);
+	uint64_t start = get_time_ns();
+	if (!ring_init(ring, config->depth, config->block_size, config->high_watermark, config->low_watermark))
+		return 0;
+	render_start(&(context.session), &(config->limits));
+	if (pthread_create(&thread, NULL, render_thread, &context)) {
+		ring_free(ring);
+		return 0;
+	}
+
+	/* Output thread (consumer) */
+	uint8_t success = 1;
+	const uint8_t *block;
+	uint32_t length;
+	while ((block = ring_acquire_read(ring, &length))) {
+		if (!sink_write(&output_sink, block, length))
+			success = 0; // Keep draining, render thread may be waiting
+		stats->samples += length;
+		ring_release_read(ring);
+	}
+
+	/* Wait end of render thread */
+	pthread_join(thread, NULL);
+	stats->elapsed_ns = get_time_ns() - start;
+	stats->underruns = ring->underruns;
+	stats->throttles = ring->throttles;
+	stats->max_fill = ring->max_fill;
+	stats->status = context.session.status;
+	ring_free(ring);
+	return success;
+}
+
+uint8_t player_run_paced(const Player_config_t *config, Player_stats_t *stats) {
+	Render_session_t session;
+	uint8_t *block = malloc(config->block_size);
+	if (!block)
+		return 0;
+
+	/* First deadline is now */
+	clear_stats(stats);
+	render_start(&session, &(config->limits));
+	uint8_t success = 1;
+	uint64_t start = get_time_ns();
+
+	while (session.status == RENDER_OK) {
+
+		/* Render and output one block */
+		uint32_t length = render_samples(&session, block, config->block_size);
+		if (!sink_write(&output_sink, block, length))
+			success = 0;
+		stats->samples += length;
+		++(stats->periods);
+
+		/* Deadline of next block (computed from start, no drift) */
+		uint64_t deadline = start + (stats->samples * NS_PER_SECOND) / SAMPLE_RATE;
+		uint64_t now = get_time_ns();
+		if (now > deadline) {
+			++(stats->deadline_misses);
+			if (now - deadline > stats->max_lateness_ns)
+				stats->max_lateness_ns = now - deadline;
+			continue;
+		}
+
+		/* Sleep until deadline */
+		struct timespec wakeup = { deadline / NS_PER_SECOND, deadline % NS_PER_SECOND };
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL))
+			; // Interrupted by signal
+	}
+
+	stats->elapsed_ns = get_time_ns() - start;
+	stats->status = session.status;
+	free(block);
+	return success;
+}
+
+uint8_t player_run_offline(const Player_config_t *config, Player_stats_t *stats) {
+	Render_session_t session;
+	uint8_t *block = malloc(config->block_size);
+	if (!block)
+		return 0;
+
+	/* Render as fast as possible */
+	clear_stats(stats);
+	render_start(&session, &(config->limits));
+	uint8_t success = 1;
+	uint64_t start = get_time_ns();
+	while (session.status == RENDER_OK) {
+		uint32_t length = render_samples(&session, block, config->block_size);
+		if (!sink_write(&output_sink, block, length))
+			success = 0;
+		stats->samples += length;
+	}
+
+	stats->elapsed_ns = get_time_ns() - start;
+	stats->status = session.status;
+	free(block);
+	return success;
+}
+
+/* Render status names */
+static const char *status_names[] = { "running", "end of stream", "loop limit", "duration limit" };
+
+void player_print_stats(const Player_stats_t *stats) {
+	double elapsed = (double)stats->elapsed_ns / NS_PER_SECOND;
+	double duration = (double)stats->samples / SAMPLE_RATE;
+
+	fprintf(stderr, "Stopped on %s\n", status_names[stats->status]);
+	fprintf(stderr, "%llu samples (%.3f s) in %.3f s : %.0f samples/s, real-time factor %.1f\n",
+			(unsigned long long)stats->samples, duration, elapsed,
+			elapsed > 0 ? stats->samples / elapsed : 0, elapsed > 0 ? duration / elapsed : 0);
+#if defined(THREADED_OUTPUT) || defined(FANOUT_OUTPUT)
+	fprintf(stderr, "%u underruns, max %u blocks ready, render throttled %u times\n", stats->underruns, stats->max_fill, stats->throttles);
+#elif defined(PACED_OUTPUT)
+	fprintf(stderr, "%u periods, %u deadline misses, max lateness %llu us\n",
+			stats->periods, stats->deadline_misses, (unsigned long long)(stats->max_lateness_ns / 1000));
+#endif
+}
+
+#endif
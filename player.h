@@ -0,0 +1,126 @@
+/**
+ * @file player.h
+ * @brief Generic digital chiptune generator - Computer player
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle render the tracker file by blocks (see render.h) and write them to the output sink,
+ * until END_OF_STREAM or the configured duration / loop limit.\n
+ * Three run modes are available :
+ * - Threaded : render and output in two threads decoupled by a single producer / single consumer ring of blocks (see ring.h)
+ * - Paced : render one block per period on an absolute deadline schedule (clock_nanosleep), sleep between periods
+ * - Offline : render as fast as possible, with throughput statistics
+ *
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define THREADED_OUTPUT, PACED_OUTPUT or OFFLINE_OUTPUT in common.h to use this functions bundle (linux port only, link with -lpthread)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _PLAYER_H_
+#define _PLAYER_H_
+
+/**
+ * Default number of blocks in ring
+ */
+#define PLAYER_RING_DEPTH 16
+
+/**
+ * Default size of one block (in samples)
+ */
+#define PLAYER_BLOCK_SIZE 4096
+
+/**
+ * Default high watermark (render stop when this number of blocks are ready)
+ */
+#define PLAYER_HIGH_WATERMARK 12
+
+/**
+ * Default low watermark (render restart when this number of blocks are ready)
+ */
+#define PLAYER_LOW_WATERMARK 4
+
+/**
+ * Size of one block in paced mode (in samples, 256 samples = 32ms @8KHz)
+ */
+#define PLAYER_PACED_BLOCK_SIZE 256
+
+/**
+ * Player configuration structure
+ */
+typedef struct {
+	uint32_t block_size;     // Size of one block (in samples)
+	uint32_t depth;          // Threaded mode
+	uint32_t high_watermark; // Threaded mode
+	uint32_t low_watermark;  // Threaded mode
+	Render_limits_t limits;
+} Player_config_t;
+
+/**
+ * Player statistics structure
+ */
+typedef struct {
+	uint64_t samples;
+	uint64_t elapsed_ns;
+	uint32_t underruns;       // Threaded mode
+	uint32_t throttles;       // Threaded mode (render ahead of output, not an error)
+	uint32_t max_fill;        // Threaded mode
+	uint32_t periods;         // Paced mode
+	uint32_t deadline_misses; // Paced mode
+	uint64_t max_lateness_ns; // Paced mode
+	uint8_t status;           // Render status at end of player
+} Player_stats_t;
+
+/**
+ * Render the tracker file in a render thread and write samples to output sink in the calling thread
+ *
+ * @param config Pointer to a Player_config_t object
+ * @param stats Pointer to a Player_stats_t object (filled at end of render)
+ * @return 1 on success, 0 on error
+ */
+uint8_t player_run_threaded(const Player_config_t *config, Player_stats_t *stats);
+
+/**
+ * Render the tracker file in real-time (one block per period, sleep between periods)
+ *
+ * @param config Pointer to a Player_config_t object
+ * @param stats Pointer to a Player_stats_t object (filled at end of render)
+ * @return 1 on success, 0 on error
+ */
+uint8_t player_run_paced(const Player_config_t *config, Player_stats_t *stats);
+
+/**
+ * Render the tracker file as fast as possible
+ *
+ * @param config Pointer to a Player_config_t object
+ * @param stats Pointer to a Player_stats_t object (filled at end of render)
+ * @return 1 on success, 0 on error
+ */
+uint8_t player_run_offline(const Player_config_t *config, Player_stats_t *stats);
+
+/**
+ * Print player statistics on stderr (samples/s and real-time factor)
+ *
+ * @param stats Pointer to a Player_stats_t object
+ */
+void player_print_stats(const Player_stats_t *stats);
+
+#endif // _PLAYER_H_
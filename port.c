@@ -17,6 +17,7 @@
  
 /* Includes */
 #include <stdint.h>
+#include "common.h"
 #include "port.h"
 #include "tracker_data.h"
 
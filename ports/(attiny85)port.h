@@ -36,6 +36,25 @@
  */
 #define value(x)  low(x), high(x) // Little-endian
 
+/**
+ * No hardware multiplier : shift-add gain stage, unless the gain table is selected (see scale_value() in mixer.h)
+ */
+#ifndef SCALE_GAIN_TABLE
+#define SCALE_SHIFT_ADD
+#endif
+
+/**
+ * Only 512 bytes of SRAM : one user ADSR envelope per channel (13 bytes per envelope), unless set by the user
+ */
+#ifdef ADSR_ENVELOPES_DEFAULT
+#undef ADSR_ENVELOPES
+#if NUMBERS_OF_CHANNEL < 16
+#define ADSR_ENVELOPES NUMBERS_OF_CHANNEL
+#else
+#define ADSR_ENVELOPES 16
+#endif
+#endif
+
 /**
  * Timer handling function name 
  */
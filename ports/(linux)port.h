@@ -0,0 +1,192 @@
+/**
+ * @file port.h
+ * @brief Linux computer port of generic chiptune generator
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This port is for linux (and other POSIX system) computer.\n
+ * Output sound is redirected to an output sink (see sink.h), by default a raw (8bits, unsigned value) music file named "output.raw".\n
+ * Samples are gathered in blocks of SINK_BLOCK_SIZE bytes, one system call is done per block.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Take a look at common.h header file for runtime configuration
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _PORT_H_
+#define _PORT_H_
+
+/**
+ * Output sink support (build sink.c)
+ */
+#define OUTPUT_SINK
+
+/**
+ * 16 bits and float output support (OUTPUT_S16 and OUTPUT_F32, see common.h)
+ */
+#define PORT_WIDE_OUTPUT
+
+/**
+ * Multichannel output support (OUTPUT_CHANNELS, see common.h), samples of a frame are interleaved
+ */
+#define PORT_MULTICHANNEL_OUTPUT
+
+/* Dependency */
+#include <stdio.h>  // For puts
+#include <stdlib.h> // For exit code
+#include "sink.h"   // For output sink
+
+/**
+ * Output sink configuration (SINK_RAW, SINK_WAV, SINK_ADPCM, SINK_STDOUT, SINK_SHM or SINK_NULL)
+ */
+#define OUTPUT_SINK_TYPE SINK_RAW
+
+/**
+ * Output file name (SINK_RAW and SINK_WAV) or shared memory object name (SINK_SHM, like "/chiptune")
+ */
+#define OUTPUT_FILENAME "output.raw"
+
+/**
+ * Second and third outputs of fan-out output mode (FANOUT_OUTPUT, see common.h) : 16 bits WAV file and IMA-ADPCM WAV file,
+ * the first output is the output sink
+ */
+#define FANOUT_WAV_FILENAME "output_s16.wav"
+#define FANOUT_ADPCM_FILENAME "output_adpcm.wav"
+
+#if defined(CYCLE_COUNTER) && !defined(__x86_64__) && !defined(__i386__)
+#include <time.h>   // For clock_gettime
+
+/**
+ * Cycle counter (see profile.h), nanoseconds when the TSC is not available
+ */
+static inline uint32_t read_profile_counter(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+#define PROFILE_CYCLES() read_profile_counter()
+#define PROFILE_CYCLES_HZ 1000000000UL
+#endif
+
+/**
+ * PROGMEM macro
+ */
+#define PROGMEM
+
+/**
+ * Get a byte (8 bits) from PROGMEM function
+ *
+ * @param address Address of byte in memory
+ * @return Byte value
+ */
+inline uint8_t pgm_read_byte(const uint8_t *address) {
+	return *address;
+}
+
+/**
+ * Get a word (16 bits) from PROGMEM function
+ *
+ * @param address Address of word in memory
+ * @return Word value
+ */
+inline uint16_t pgm_read_word(const uint8_t *address) {
+	return ((uint16_t)(*address) << 8) | *(address + 1);
+}
+
+/**
+ * 2 bytes value ordering macro
+ */
+#define value(x) high(x), low(x)
+
+/**
+ * Timer handling function name
+ */
+#define TIMER_ISR_FUNCTION void sampling_fnct(void)
+
+/**
+ * System init function
+ */
+static inline void system_init(void) {
+	const Sink_format_t format = { SAMPLE_RATE, OUTPUT_CHANNELS, OUTPUT_SAMPLE_BITS };
+	if (!sink_open(&output_sink, OUTPUT_SINK_TYPE, OUTPUT_FILENAME, &format)) {
+		perror("Unable to open output sink");
+		exit(1);
+	}
+}
+
+/**
+ * Timer init function
+ *
+ * @param sample_rate Sampling rate frequency of output sound
+ */
+static inline void timer_init(uint32_t sample_rate) {
+
+}
+
+/**
+ * Re-arm sampling timer function
+ */
+static inline void rearm_sampling_timer(void) {
+
+}
+
+/**
+ * Output sample to speaker
+ *
+ * @param sample Output sample to send to speaker
+ * @remarks 16 bits and float samples are written in host byte order (little-endian for WAV files)
+ */
+static inline void output_sample_dac(OUTPUT_SAMPLE_TYPE sample) {
+#if OUTPUT_SAMPLE_BITS == 8
+	sink_put(&output_sink, sample);
+#else
+	const uint8_t *bytes = (const uint8_t *)&sample;
+	for (uint8_t i = 0; i < sizeof(sample); ++i)
+		sink_put(&output_sink, bytes[i]);
+#endif
+}
+
+/**
+ * Stop timer and dac function
+ */
+static inline void stop_timer_dac(void) {
+	sink_close(&output_sink);
+}
+
+/* ---------- */
+
+/**
+ * Get byte from tracker data
+ *
+ * @param address Base address of byte
+ * @return Byte value from tracker data
+ */
+uint8_t get_byte_from_tracker(const uint16_t address);
+
+/**
+ * Get word from tracker data
+ *
+ * @param address Base address of word
+ * @return Word value from tracker data
+ */
+uint16_t get_word_from_tracker(const uint16_t address);
+
+#endif // _PORT_H_
@@ -37,6 +37,14 @@
 #include <lpc_types.h> // For hardcoded type
 #include <LPC17xx.h>   // For everything related to LPC17xx
 
+/**
+ * 16 bits output support (OUTPUT_S16, see common.h)
+ */
+#define PORT_WIDE_OUTPUT
+#ifdef OUTPUT_F32
+#error "The LPC1768 port doesn't support float output (DAC)"
+#endif
+
 /**
  * PROGMEM macro
  */
@@ -72,6 +80,25 @@ inline uint16_t pgm_read_word(const uint8_t *address) {
  */
 #define TIMER_ISR_FUNCTION void RIT_IRQHandler(void)
 
+#ifdef CYCLE_COUNTER
+/**
+ * Debug and DWT registers for the cycle counter (see profile.h)
+ */
+#define PROFILE_DEMCR (*(volatile uint32_t *)0xE000EDFC)
+#define PROFILE_DWT_CTRL (*(volatile uint32_t *)0xE0001000)
+#define PROFILE_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004)
+
+/**
+ * Cycle counter (DWT cycle counter)
+ */
+#define PROFILE_CYCLES() PROFILE_DWT_CYCCNT
+
+/**
+ * Frequency of the cycle counter (core clock)
+ */
+#define PROFILE_CYCLES_HZ SystemCoreClock
+#endif
+
 /**
  * System init function 
  */
@@ -79,6 +106,11 @@ static inline void system_init(void) {
 	SystemInit();
 	SystemCoreClockUpdate();
 	LPC_PINCON->PINSEL1 = 0x00200000; // Set p0.26 to DAC output
+#ifdef CYCLE_COUNTER
+	PROFILE_DEMCR |= (1 << 24); // Enable trace (TRCENA)
+	PROFILE_DWT_CYCCNT = 0;
+	PROFILE_DWT_CTRL |= (1 << 0); // Enable cycle counter (CYCCNTENA)
+#endif
 }
 
 /** 
@@ -111,9 +143,15 @@ static inline void rearm_sampling_timer(void) {
  *
  * @param sample Output sample to send to speaker
  */
+#ifdef OUTPUT_S16
+static inline void output_sample_dac(int16_t sample) {
+	LPC_DAC->DACR = ((uint16_t)sample ^ 0x8000) & 0xFFC0; // Unsigned, 10 most significant bits in VALUE section (bits 6 to 15)
+}
+#else
 static inline void output_sample_dac(uint8_t sample) {
 	LPC_DAC->DACR = sample << (6 + 2); // 6 for reserved bits section + 2 (8 bits -> 10 bits)
 }
+#endif
 
 /**
  * Stop timer and dac function 
@@ -0,0 +1,215 @@
+/**
+ * @file port.h
+ * @brief Simulation port of generic chiptune generator (MCU timer and DAC on linux)
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This port is for linux (and other POSIX system) computer, it simulate the sampling timer and the DAC of a MCU (see simulation.h).\n
+ * The CPU budget of the sampling interrupt, the interrupt jitter and the DAC resolution are configurable (below),
+ * the output sink record the DAC output at the end of each sample period, by default in a raw (8bits, unsigned value) music file named "output.raw".\n
+ * With the default configuration the output is the same as the linux port, late samples are heard as repeated / dropped samples.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Take a look at common.h header file for runtime configuration
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _PORT_H_
+#define _PORT_H_
+
+/**
+ * Output sink and simulation support (build sink.c and simulation.c)
+ */
+#define OUTPUT_SINK
+#define SIMULATION_PORT
+
+/**
+ * 16 bits output support (OUTPUT_S16, see common.h)
+ */
+#define PORT_WIDE_OUTPUT
+#ifdef OUTPUT_F32
+#error "The simulation port doesn't support float output (DAC)"
+#endif
+
+/* Dependency */
+#include <stdio.h>        // For puts
+#include <stdlib.h>       // For exit code
+#include "sink.h"         // For output sink
+#include "simulation.h"   // For simulated timer and DAC
+
+/**
+ * Output sink configuration (SINK_RAW, SINK_WAV, SINK_ADPCM, SINK_STDOUT, SINK_SHM or SINK_NULL)
+ */
+#define OUTPUT_SINK_TYPE SINK_RAW
+
+/**
+ * Output file name (SINK_RAW and SINK_WAV) or shared memory object name (SINK_SHM, like "/chiptune")
+ */
+#define OUTPUT_FILENAME "output.raw"
+
+/**
+ * Share of the target CPU left to the sampling interrupt by the application, in percent (100 : whole CPU)
+ *
+ * @remarks The render time measured on computer is scaled to the target by CPU_SLOWDOWN_PERCENT (see common.h)
+ */
+#define SIM_CPU_BUDGET_PERCENT 100
+
+/**
+ * Fixed duration of the sampling interrupt in nanoseconds, for reproducible runs (0 : measured render time)
+ */
+#define SIM_ISR_COST_NS 0
+
+/**
+ * Maximum interrupt latency (uniform random jitter) in nanoseconds, and seed of the jitter generator
+ */
+#define SIM_JITTER_NS 0
+#define SIM_SEED 1
+
+/**
+ * DAC resolution in bits (8 : PWM, 10 : LPC1768 DAC, up to 16)
+ */
+#define SIM_DAC_BITS 10
+
+/**
+ * Timing file name (CSV, one line per sample : due time, start time and DAC write time, uncomment this define to enable)
+ */
+//#define SIM_TIMING_FILENAME "timing.csv"
+
+#if defined(CYCLE_COUNTER) && !defined(__x86_64__) && !defined(__i386__)
+#include <time.h>   // For clock_gettime
+
+/**
+ * Cycle counter (see profile.h), nanoseconds when the TSC is not available
+ */
+static inline uint32_t read_profile_counter(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+#define PROFILE_CYCLES() read_profile_counter()
+#define PROFILE_CYCLES_HZ 1000000000UL
+#endif
+
+/**
+ * PROGMEM macro
+ */
+#define PROGMEM
+
+/**
+ * Get a byte (8 bits) from PROGMEM function
+ *
+ * @param address Address of byte in memory
+ * @return Byte value
+ */
+inline uint8_t pgm_read_byte(const uint8_t *address) {
+	return *address;
+}
+
+/**
+ * Get a word (16 bits) from PROGMEM function
+ *
+ * @param address Address of word in memory
+ * @return Word value
+ */
+inline uint16_t pgm_read_word(const uint8_t *address) {
+	return ((uint16_t)(*address) << 8) | *(address + 1);
+}
+
+/**
+ * 2 bytes value ordering macro
+ */
+#define value(x) high(x), low(x)
+
+/**
+ * Timer handling function name
+ */
+#define TIMER_ISR_FUNCTION void sampling_fnct(void)
+
+/**
+ * System init function
+ */
+static inline void system_init(void) {
+	const Sink_format_t format = { SAMPLE_RATE, 1, OUTPUT_SAMPLE_BITS };
+	if (!sink_open(&output_sink, OUTPUT_SINK_TYPE, OUTPUT_FILENAME, &format)) {
+		perror("Unable to open output sink");
+		exit(1);
+	}
+}
+
+/**
+ * Timer init function
+ *
+ * @param sample_rate Sampling rate frequency of output sound
+ */
+static inline void timer_init(uint32_t sample_rate) {
+	if (!simulation_start(sample_rate)) {
+		perror("Unable to open timing file");
+		exit(1);
+	}
+}
+
+/**
+ * Re-arm sampling timer function
+ */
+static inline void rearm_sampling_timer(void) {
+	simulation_isr_enter();
+}
+
+/**
+ * Output sample to speaker
+ *
+ * @param sample Output sample to send to speaker
+ */
+static inline void output_sample_dac(OUTPUT_SAMPLE_TYPE sample) {
+#if OUTPUT_SAMPLE_BITS == 8
+	simulation_dac_write((uint16_t)sample << 8);
+#else
+	simulation_dac_write((uint16_t)sample ^ 0x8000);
+#endif
+}
+
+/**
+ * Stop timer and dac function
+ */
+static inline void stop_timer_dac(void) {
+	simulation_stop();
+	sink_close(&output_sink);
+}
+
+/* ---------- */
+
+/**
+ * Get byte from tracker data
+ *
+ * @param address Base address of byte
+ * @return Byte value from tracker data
+ */
+uint8_t get_byte_from_tracker(const uint16_t address);
+
+/**
+ * Get word from tracker data
+ *
+ * @param address Base address of word
+ * @return Word value from tracker data
+ */
+uint16_t get_word_from_tracker(const uint16_t address);
+
+#endif // _PORT_H_
@@ -0,0 +1,169 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For tracker commands
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+#include "profile.h"      // For profile structure
+
+#ifdef CYCLE_COUNTER
+
+#ifndef PROFILE_CYCLES_HZ
+#ifdef EMULATE_TIMER
+#include <time.h>         // For clock_gettime
+
+/* Measure the frequency of the cycle counter against the monotonic clock (about 50ms) */
+static uint32_t measure_cycles_hz(void) {
+	struct timespec start, now;
+	uint64_t elapsed_ns;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	uint32_t start_cycles = PROFILE_CYCLES();
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed_ns = (uint64_t)(now.tv_sec - start.tv_sec) * 1000000000ULL + now.tv_nsec - start.tv_nsec;
+	} while (elapsed_ns < 50000000ULL);
+	uint32_t cycles = PROFILE_CYCLES() - start_cycles;
+	return ((uint64_t)cycles * 1000000000ULL) / elapsed_ns;
+}
+#define PROFILE_CYCLES_HZ measure_cycles_hz()
+#else
+#error "DEADLINE_MONITOR and ADAPTIVE_QUALITY need the frequency of the cycle counter, define PROFILE_CYCLES_HZ in port.h"
+#endif
+#endif
+
+uint32_t profile_sample_budget(void) {
+	uint32_t budget = ((uint64_t)PROFILE_CYCLES_HZ * 100) / ((uint64_t)SAMPLE_RATE * CPU_SLOWDOWN_PERCENT);
+	return budget ? budget : 1;
+}
+
+#endif
+
+#ifdef ISR_PROFILING
+
+/* Statistics of each stage */
+volatile Profile_stage_t profile_stages[PROFILE_STAGES];
+
+/* Current sample */
+uint32_t profile_laps[PROFILE_STAGES];
+uint32_t profile_lap_time;
+uint32_t profile_start_time;
+
+/* Get histogram bucket of a value (PROFILE_HISTOGRAM_BITS bits of mantissa per power of two) */
+static inline uint8_t get_bucket(uint32_t value) {
+	if (value < (1UL << PROFILE_HISTOGRAM_BITS))
+		return value;
+	uint8_t msb = 31 - __builtin_clz(value);
+	return ((msb - PROFILE_HISTOGRAM_BITS + 1) << PROFILE_HISTOGRAM_BITS)
+			+ ((value >> (msb - PROFILE_HISTOGRAM_BITS)) & ((1UL << PROFILE_HISTOGRAM_BITS) - 1));
+}
+
+/* Get highest value of a histogram bucket */
+static inline uint32_t get_bucket_limit(uint8_t bucket) {
+	if (bucket < (1UL << PROFILE_HISTOGRAM_BITS))
+		return bucket;
+	uint8_t msb = (bucket >> PROFILE_HISTOGRAM_BITS) + PROFILE_HISTOGRAM_BITS - 1;
+	uint32_t mantissa = bucket & ((1UL << PROFILE_HISTOGRAM_BITS) - 1);
+	uint32_t low = (1UL << msb) | (mantissa << (msb - PROFILE_HISTOGRAM_BITS));
+	return low + ((1UL << (msb - PROFILE_HISTOGRAM_BITS)) - 1);
+}
+
+void profile_record(uint8_t stage, uint32_t cycles) {
+	volatile Profile_stage_t *current = profile_stages + stage;
+	if (current->count == 0 || cycles < current->min)
+		current->min = cycles;
+	if (cycles > current->max)
+		current->max = cycles;
+	++(current->count);
+	current->sum += cycles;
+	++(current->histogram[get_bucket(cycles)]);
+}
+
+void profile_end_sample(void) {
+	profile_lap(PROFILE_MIXING);
+	profile_record(PROFILE_TEMPO, profile_laps[PROFILE_TEMPO]);
+	profile_record(PROFILE_OSCILLATORS, profile_laps[PROFILE_OSCILLATORS]);
+	profile_record(PROFILE_ENVELOPES, profile_laps[PROFILE_ENVELOPES]);
+	profile_record(PROFILE_MIXING, profile_laps[PROFILE_MIXING]);
+	profile_record(PROFILE_TOTAL, profile_lap_time - profile_start_time);
+	profile_lap_time = PROFILE_CYCLES(); // Don't count profiler in output stage
+}
+
+void profile_reset(void) {
+	for (uint8_t stage = 0; stage < PROFILE_STAGES; ++stage) {
+		profile_stages[stage].count = 0;
+		profile_stages[stage].min = 0;
+		profile_stages[stage].max = 0;
+		profile_stages[stage].sum = 0;
+		for (uint8_t bucket = 0; bucket < PROFILE_BUCKETS; ++bucket)
+			profile_stages[stage].histogram[bucket] = 0;
+	}
+}
+
+void profile_snapshot(Profile_stage_t *stages) {
+	for (uint8_t stage = 0; stage < PROFILE_STAGES; ++stage) {
+		stages[stage].count = profile_stages[stage].count;
+		stages[stage].min = profile_stages[stage].min;
+		stages[stage].max = profile_stages[stage].max;
+		stages[stage].sum = profile_stages[stage].sum;
+		for (uint8_t bucket = 0; bucket < PROFILE_BUCKETS; ++bucket)
+			stages[stage].histogram[bucket] = profile_stages[stage].histogram[bucket];
+	}
+}
+
+uint32_t profile_percentile(const Profile_stage_t *stage, uint16_t permille) {
+	uint64_t target = ((uint64_t)stage->count * permille + 999) / 1000;
+	uint64_t seen = 0;
+	for (uint8_t bucket = 0; bucket < PROFILE_BUCKETS; ++bucket) {
+		seen += stage->histogram[bucket];
+		if (seen >= target && seen)
+			return (get_bucket_limit(bucket) < stage->max) ? get_bucket_limit(bucket) : stage->max;
+	}
+	return stage->max;
+}
+
+#ifdef EMULATE_TIMER
+#include <stdio.h>        // For fprintf
+
+/* Stage names */
+static const char *stage_names[PROFILE_STAGES] = { "tempo", "oscillators", "envelopes", "mixing", "output", "total" };
+
+void profile_dump(void) {
+	static Profile_stage_t stages[PROFILE_STAGES];
+	profile_snapshot(stages);
+
+	fprintf(stderr, "%-12s %10s %8s %10s %8s %8s %8s %8s %8s\n", "stage (cycles)", "count", "min", "mean", "p50", "p90", "p99", "p99.9", "max");
+	for (uint8_t stage = 0; stage < PROFILE_STAGES; ++stage) {
+		const Profile_stage_t *current = stages + stage;
+		if (current->count == 0)
+			continue;
+		fprintf(stderr, "%-14s %10lu %8lu %10.1f %8lu %8lu %8lu %8lu %8lu\n", stage_names[stage],
+				(unsigned long)current->count, (unsigned long)current->min, (double)current->sum / current->count,
+				(unsigned long)profile_percentile(current, 500), (unsigned long)profile_percentile(current, 900),
+				(unsigned long)profile_percentile(current, 990), (unsigned long)profile_percentile(current, 999),
+				(unsigned long)current->max);
+	}
+}
+#endif
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file profile.h
+ * @brief Generic digital chiptune generator - Sampling ISR profiler
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle count the cycles spent in each stage of the sampling ISR :
+ * tempo tick (tracker), oscillators, envelopes, mixing, DAC output, and the whole mixer_render_sample().\n
+ * Oscillators, envelopes and mixing stages are the sum over all channels.\n
+ * Each stage keep count, min, mean, max and a logarithmic histogram (for percentiles).\n
+ * Statistics can be read live with profile_snapshot() and printed at end of stream with profile_dump() (computer only).\n
+ * Cycles are read with PROFILE_CYCLES() : TSC on x86, otherwise the port header must define it (like the DWT cycle counter of the LPC1768 port).\n
+ * When ISR_PROFILING is not defined every profiling call expand to nothing (zero overhead).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define ISR_PROFILING in common.h to use this functions bundle
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+/**
+ * Profiled stages
+ */
+typedef enum {
+	PROFILE_TEMPO,       // tracker_tempo_tick()
+	PROFILE_OSCILLATORS, // get_waveform_sample() and prepare_next_sample() of all channels
+	PROFILE_ENVELOPES,   // get_envelope_sample() of all channels
+	PROFILE_MIXING,      // Scaling, mixing, mapping and global volume
+	PROFILE_OUTPUT,      // output_sample_dac() (sampling ISR only)
+	PROFILE_TOTAL,       // Whole mixer_render_sample()
+	PROFILE_STAGES
+} Profile_stage_name_t;
+
+#ifdef CYCLE_COUNTER
+
+/* Cycle counter (PROFILE_CYCLES_HZ : frequency of the counter, measured at runtime when not defined) */
+#ifndef PROFILE_CYCLES
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // For __rdtsc
+#define PROFILE_CYCLES() ((uint32_t)__rdtsc())
+#else
+#error "ISR_PROFILING, DEADLINE_MONITOR and ADAPTIVE_QUALITY need a cycle counter, define PROFILE_CYCLES() in port.h"
+#endif
+#endif
+
+/**
+ * Get the render budget of one sample (1 / SAMPLE_RATE, scaled by CPU_SLOWDOWN_PERCENT)
+ *
+ * @return Cycles of PROFILE_CYCLES()
+ * @remarks On computer the frequency of the counter is measured (about 50ms) when the port doesn't define PROFILE_CYCLES_HZ
+ */
+uint32_t profile_sample_budget(void);
+
+#endif
+
+#ifdef ISR_PROFILING
+
+/**
+ * Number of sub-buckets bits of histogram (2 : 4 buckets per power of two, about 20% precision on percentiles)
+ *
+ * @remarks Use 0 on small MCU (32 buckets per stage)
+ */
+#ifndef PROFILE_HISTOGRAM_BITS
+#define PROFILE_HISTOGRAM_BITS 2
+#endif
+
+/**
+ * Number of buckets of histogram
+ */
+#define PROFILE_BUCKETS ((33 - PROFILE_HISTOGRAM_BITS) << PROFILE_HISTOGRAM_BITS)
+
+/**
+ * Stage statistics structure (cycles)
+ */
+typedef struct {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+	uint32_t histogram[PROFILE_BUCKETS];
+} Profile_stage_t;
+
+/**
+ * Statistics of each stage (updated by the sampling ISR)
+ */
+extern volatile Profile_stage_t profile_stages[PROFILE_STAGES];
+
+/**
+ * Cycles of each stage of current sample
+ */
+extern uint32_t profile_laps[PROFILE_STAGES];
+
+/**
+ * Cycle counter at end of last lap, and at start of current sample
+ */
+extern uint32_t profile_lap_time;
+extern uint32_t profile_start_time;
+
+/**
+ * Add one measure to a stage
+ *
+ * @param stage Stage to update
+ * @param cycles Measured cycles
+ */
+void profile_record(uint8_t stage, uint32_t cycles);
+
+/**
+ * Start profiling a sample
+ */
+inline void profile_begin_sample(void) {
+	for (uint8_t stage = 0; stage < PROFILE_STAGES; ++stage)
+		profile_laps[stage] = 0;
+	profile_start_time = profile_lap_time = PROFILE_CYCLES();
+}
+
+/**
+ * Add cycles since last lap to a stage of current sample
+ *
+ * @param stage Stage to update
+ */
+inline void profile_lap(uint8_t stage) {
+	uint32_t now = PROFILE_CYCLES();
+	profile_laps[stage] += now - profile_lap_time;
+	profile_lap_time = now;
+}
+
+/**
+ * End profiling a sample (record tempo, oscillators, envelopes, mixing and total stages)
+ */
+void profile_end_sample(void);
+
+/**
+ * Record cycles since last lap as the output stage (call after output_sample_dac())
+ */
+inline void profile_output(void) {
+	profile_record(PROFILE_OUTPUT, PROFILE_CYCLES() - profile_lap_time);
+}
+
+/**
+ * Reset statistics of all stages
+ */
+void profile_reset(void);
+
+/**
+ * Copy statistics of all stages (can be called while the sampling ISR is running)
+ *
+ * @param stages Array of PROFILE_STAGES Profile_stage_t objects
+ * @remarks The copy of a stage updated during the call can be inconsistent (count / sum / histogram)
+ */
+void profile_snapshot(Profile_stage_t *stages);
+
+/**
+ * Get a percentile of a stage (upper bound of histogram bucket)
+ *
+ * @param stage Pointer to a Profile_stage_t object
+ * @param permille Percentile in per mille (0 to 1000, 999 for p99.9)
+ * @return Cycles
+ */
+uint32_t profile_percentile(const Profile_stage_t *stage, uint16_t permille);
+
+#ifdef EMULATE_TIMER
+/**
+ * Print statistics of all stages on stderr (min / mean / p50 / p90 / p99 / p99.9 / max cycles)
+ */
+void profile_dump(void);
+#endif
+
+#else
+
+/* Profiling disabled : no code at all */
+#define profile_begin_sample()
+#define profile_lap(stage)
+#define profile_end_sample()
+#define profile_output()
+#define profile_reset()
+#define profile_dump()
+
+#endif
+
+#endif // _PROFILE_H_
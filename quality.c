@@ -0,0 +1,157 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For tracker commands
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+#include "profile.h"      // For cycle counter
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool
+#include "quality.h"      // For quality structure
+
+#ifdef ADAPTIVE_QUALITY
+
+/* Adaptive quality state */
+volatile Quality_t quality;
+
+/* Degradation events counters */
+volatile Quality_stats_t quality_stats;
+
+/* Mute the quietest voice rendered by the mixer (envelope x channel volume) */
+static void drop_quietest_voice(void) {
+	uint8_t quietest = NUMBERS_OF_CHANNEL;
+	uint32_t quietest_loudness = 0x10000;
+	for (uint8_t channel = 0; channel < MIXER_VOICES; ++channel) {
+		uint16_t loudness = (uint16_t)quality.envelopes[channel] * mixer.channels[channel].volume;
+		if (!quality.dropped[channel] && loudness < quietest_loudness) {
+			quietest = channel;
+			quietest_loudness = loudness;
+		}
+	}
+	if (quietest == NUMBERS_OF_CHANNEL) // Every voice already muted
+		return;
+	quality.dropped[quietest] = 1;
+	quality.drop_order[quality.dropped_count++] = quietest;
+	++(quality_stats.voice_drops);
+}
+
+/* Raise quality level by one */
+static void raise_level(void) {
+	if (quality.raised || quality.level >= QUALITY_MAX_LEVEL)
+		return;
+	quality.raised = 1;
+	quality.headroom_samples = 0;
+	++(quality.level);
+	++(quality_stats.raises);
+	if (quality.level > quality_stats.max_level)
+		quality_stats.max_level = quality.level;
+
+	if (quality.level >= QUALITY_DROP_VOICES)
+		drop_quietest_voice();
+}
+
+/* Lower quality level by one */
+static void lower_level(void) {
+	if (quality.level >= QUALITY_DROP_VOICES && quality.dropped_count)
+		quality_restore_voice(quality.drop_order[--quality.dropped_count]);
+	--(quality.level);
+	++(quality_stats.restores);
+}
+
+void quality_reset(void) {
+	quality.budget = profile_sample_budget();
+	quality.high_threshold = ((uint64_t)quality.budget * QUALITY_HIGH_PERCENT) / 100;
+	quality.low_threshold = ((uint64_t)quality.budget * QUALITY_LOW_PERCENT) / 100;
+	quality.headroom_samples = 0;
+	quality.level = QUALITY_FULL;
+	quality.raised = 0;
+	quality.control_phase = 0;
+	quality.dropped_count = 0;
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		quality.dropped[channel] = 0;
+		quality.envelopes[channel] = 0;
+		quality.envelope_phases[channel] = 0xFF; // One sample before the first update
+	}
+	envelope_ticks = 1;
+	noise_hold = 0;
+
+	quality_stats.raises = 0;
+	quality_stats.early_raises = 0;
+	quality_stats.restores = 0;
+	quality_stats.voice_drops = 0;
+	quality_stats.degraded_samples = 0;
+	quality_stats.max_level = QUALITY_FULL;
+}
+
+void quality_restore_voice(uint8_t voice) {
+	quality.dropped[voice] = 0;
+	quality.envelope_phases[voice] = quality.control_phase - 1; // Envelope held while muted
+}
+
+void quality_check(void) {
+	if (PROFILE_CYCLES() - quality.start_time > quality.high_threshold && !quality.raised
+			&& quality.level < QUALITY_MAX_LEVEL) {
+		raise_level();
+		++(quality_stats.early_raises);
+	}
+}
+
+void quality_end_sample(void) {
+	uint32_t time = PROFILE_CYCLES() - quality.start_time;
+	++(quality.control_phase);
+	noise_hold = 0;
+
+	if (quality.level != QUALITY_FULL)
+		++(quality_stats.degraded_samples);
+
+	/* Not enough headroom */
+	if (time > quality.high_threshold) {
+		raise_level();
+		return;
+	}
+
+	/* Headroom is back */
+	if (time < quality.low_threshold && quality.level != QUALITY_FULL) {
+		if (++(quality.headroom_samples) >= QUALITY_RESTORE_SAMPLES) {
+			quality.headroom_samples = 0;
+			lower_level();
+		}
+	} else
+		quality.headroom_samples = 0;
+}
+
+#ifdef EMULATE_TIMER
+#include <stdio.h>        // For fprintf
+
+void quality_dump(void) {
+	fprintf(stderr, "quality: budget %lu cycles per sample (high %u%%, low %u%%), level %u (max %u), %lu degraded samples\n",
+			(unsigned long)quality.budget, QUALITY_HIGH_PERCENT, QUALITY_LOW_PERCENT, quality.level, quality_stats.max_level,
+			(unsigned long)quality_stats.degraded_samples);
+	fprintf(stderr, "quality: %lu raises (%lu after tempo tick), %lu restores, %lu voices muted\n",
+			(unsigned long)quality_stats.raises, (unsigned long)quality_stats.early_raises,
+			(unsigned long)quality_stats.restores, (unsigned long)quality_stats.voice_drops);
+}
+#endif
+
+#endif
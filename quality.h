@@ -0,0 +1,185 @@
+/**
+ * @file quality.h
+ * @brief Generic digital chiptune generator - Adaptive quality
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle degrade the render quality when the render time of a sample come close to its budget (1 / SAMPLE_RATE),
+ * and restore it step by step when headroom return (better lose a quiet voice than click).\n
+ * Quality levels (each level include the previous ones) :\n
+ * - QUALITY_FULL : full quality\n
+ * - QUALITY_CONTROL_RATE_ENVELOPES : envelopes are updated every QUALITY_CONTROL_RATE samples (staggered between channels)\n
+ * - QUALITY_SHARED_NOISE : noise is regenerated once per sample instead of once per channel\n
+ * - QUALITY_DROP_VOICES and greater : one more voice is muted per level (quietest voice first, at least one voice left)\n
+ * The level is raised as soon as the tempo tick (tracker opcodes) exceed QUALITY_HIGH_PERCENT of the budget,
+ * before the channels are rendered, or when a whole sample exceed it.
+ * The level is lowered by one after QUALITY_RESTORE_SAMPLES consecutive samples under QUALITY_LOW_PERCENT of the budget.\n
+ * Time is read with PROFILE_CYCLES(), the budget is given by profile_sample_budget() (see profile.h).\n
+ * When ADAPTIVE_QUALITY is not defined every quality call expand to nothing (zero overhead).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define ADAPTIVE_QUALITY in common.h to use this functions bundle, include profile.h before this file
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _QUALITY_H_
+#define _QUALITY_H_
+
+#ifdef ADAPTIVE_QUALITY
+
+/**
+ * Render time (percent of budget) which raise the quality level
+ */
+#define QUALITY_HIGH_PERCENT 75
+
+/**
+ * Render time (percent of budget) under which headroom is considered back
+ */
+#define QUALITY_LOW_PERCENT 40
+
+/**
+ * Number of consecutive samples with headroom before the quality level is lowered by one (10ms)
+ */
+#define QUALITY_RESTORE_SAMPLES (SAMPLE_RATE / 100)
+
+/**
+ * Number of samples between two updates of an envelope at control rate (power of two, up to 32)
+ */
+#define QUALITY_CONTROL_RATE 8
+
+/**
+ * Quality levels
+ */
+enum {
+	QUALITY_FULL,
+	QUALITY_CONTROL_RATE_ENVELOPES,
+	QUALITY_SHARED_NOISE,
+	QUALITY_DROP_VOICES
+};
+
+/**
+ * Highest quality level (one voice of the mixer left, see MIXER_VOICES)
+ */
+#define QUALITY_MAX_LEVEL (QUALITY_DROP_VOICES + MIXER_VOICES - 2)
+
+/**
+ * Adaptive quality structure
+ */
+typedef struct {
+	uint32_t budget;                          // Render budget of one sample (cycles)
+	uint32_t high_threshold;                  // Cycles which raise the level
+	uint32_t low_threshold;                   // Cycles under which headroom is back
+	uint32_t start_time;                      // Cycle counter at start of current sample
+	uint16_t headroom_samples;                // Consecutive samples under low threshold
+	uint8_t level;                            // Current quality level
+	uint8_t raised;                           // Level already raised during current sample
+	uint8_t control_phase;                    // Sample counter of control rate envelopes
+	uint8_t dropped_count;                    // Number of muted voices
+	uint8_t dropped[NUMBERS_OF_CHANNEL];      // Muted voices (1 = muted)
+	uint8_t drop_order[NUMBERS_OF_CHANNEL];   // Muted voices, in order of muting (restored in reverse order)
+	uint8_t envelopes[NUMBERS_OF_CHANNEL];    // Last envelope sample of each channel
+	uint8_t envelope_phases[NUMBERS_OF_CHANNEL]; // control_phase of the last envelope update of each channel
+} Quality_t;
+
+/**
+ * Degradation events counters
+ */
+typedef struct {
+	uint32_t raises;                          // Number of level raises
+	uint32_t early_raises;                    // Number of level raises after the tempo tick (before render of channels)
+	uint32_t restores;                        // Number of level restores
+	uint32_t voice_drops;                     // Number of muted voices
+	uint32_t degraded_samples;                // Number of samples rendered under full quality
+	uint8_t max_level;                        // Highest reached level
+} Quality_stats_t;
+
+/**
+ * Adaptive quality state (updated by the sampling ISR)
+ */
+extern volatile Quality_t quality;
+
+/**
+ * Degradation events counters (updated by the sampling ISR)
+ */
+extern volatile Quality_stats_t quality_stats;
+
+/**
+ * Reset quality to full and clear counters, compute the budget of one sample (call before the sampling timer start)
+ */
+void quality_reset(void);
+
+/**
+ * Start measuring a sample
+ */
+inline void quality_begin_sample(void) {
+	quality.raised = 0;
+	quality.start_time = PROFILE_CYCLES();
+}
+
+/**
+ * Raise the quality level if the tempo tick exceeded the high threshold (call before render of channels)
+ */
+void quality_check(void);
+
+/**
+ * Check if a voice is muted
+ *
+ * @param voice Voice (mixer channel) to check
+ * @return 1 if muted, 0 otherwise
+ */
+inline uint8_t quality_voice_dropped(uint8_t voice) {
+	return quality.dropped[voice];
+}
+
+/**
+ * Unmute a voice (the level is kept, the voice is muted again by next level raise)
+ *
+ * @param voice Voice (mixer channel) to unmute
+ * @remarks Used by the voice pool when every voice of the pool is muted
+ */
+void quality_restore_voice(uint8_t voice);
+
+/**
+ * End measuring a sample, raise or restore the quality level
+ */
+void quality_end_sample(void);
+
+#ifdef EMULATE_TIMER
+/**
+ * Print degradation events counters on stderr
+ */
+void quality_dump(void);
+#endif
+
+#else
+
+/* Adaptive quality disabled : no code at all */
+#define quality_reset()
+#define quality_begin_sample()
+#define quality_check()
+#define quality_voice_dropped(voice) 0
+#define quality_restore_voice(voice)
+#define quality_end_sample()
+#define quality_dump()
+
+#endif
+
+#endif // _QUALITY_H_
@@ -0,0 +1,389 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include <stdlib.h>       // For malloc
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For tracker commands
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool
+#include "render.h"       // For render structure
+
+#ifdef RENDER_API
+
+/* Tempo timer (see tracker.c) */
+extern volatile SubTimer_t tempo_timer;
+
+void engine_reset(void) {
+	reset_tracker();
+	clear_adsr_envelopes();
+#ifdef INSTRUMENT_BANK
+	clear_instruments();
+#endif
+	reset_noise_seed();
+	mixer_reset();
+}
+
+void engine_save_state(Engine_state_t *state) {
+	state->mixer = mixer;
+	for (uint8_t envelope = 0; envelope < ADSR_ENVELOPES; ++envelope)
+		state->adsr_envelopes[envelope] = adsr_envelopes[envelope];
+	state->tempo_timer = tempo_timer;
+	state->tracker_index = tracker_index;
+	state->tracker_pending = tracker_pending;
+	state->noise_seed = noise_seed;
+#ifdef VOICE_POOL
+	state->voice_pool = voice_pool;
+#endif
+#ifdef INSTRUMENT_BANK
+	for (uint8_t instrument = 0; instrument < INSTRUMENTS; ++instrument)
+		state->instruments[instrument] = instruments[instrument];
+#endif
+#ifdef MODULATION
+	state->modulation = modulation;
+#endif
+}
+
+void engine_load_state(const Engine_state_t *state) {
+	mixer = state->mixer;
+	for (uint8_t envelope = 0; envelope < ADSR_ENVELOPES; ++envelope)
+		adsr_envelopes[envelope] = state->adsr_envelopes[envelope];
+	tempo_timer = state->tempo_timer;
+	tracker_index = state->tracker_index;
+	tracker_pending = state->tracker_pending;
+	noise_seed = state->noise_seed;
+#ifdef VOICE_POOL
+	voice_pool = state->voice_pool;
+#endif
+#ifdef INSTRUMENT_BANK
+	for (uint8_t instrument = 0; instrument < INSTRUMENTS; ++instrument)
+		instruments[instrument] = state->instruments[instrument];
+#endif
+#ifdef MODULATION
+	modulation = state->modulation;
+#endif
+	tracker_end_of_stream = 0;
+}
+
+/* Compare two SubTimer objects */
+static inline uint8_t subtimer_equal(const SubTimer_t *timer_1, const SubTimer_t *timer_2) {
+	return timer_1->tick_compare == timer_2->tick_compare && timer_1->tick_counter == timer_2->tick_counter;
+}
+
+#ifdef MODULATION
+/* Compare two modulators settings */
+static inline uint8_t modulator_settings_equal(const Modulator_settings_t *settings_1, const Modulator_settings_t *settings_2) {
+	return settings_1->vibrato_depth == settings_2->vibrato_depth && settings_1->vibrato_speed == settings_2->vibrato_speed
+			&& settings_1->arpeggio == settings_2->arpeggio && settings_1->arpeggio_speed == settings_2->arpeggio_speed
+			&& settings_1->portamento == settings_2->portamento && settings_1->pwm_depth == settings_2->pwm_depth
+			&& settings_1->pwm_speed == settings_2->pwm_speed && settings_1->volume_slide == settings_2->volume_slide;
+}
+#endif
+
+uint8_t engine_state_equal(const Engine_state_t *state_1, const Engine_state_t *state_2) {
+
+	/* Compare tracker and global state */
+	if (state_1->tracker_index != state_2->tracker_index || state_1->tracker_pending != state_2->tracker_pending
+			|| state_1->noise_seed != state_2->noise_seed)
+		return 0;
+	if (!subtimer_equal(&(state_1->tempo_timer), &(state_2->tempo_timer)))
+		return 0;
+	if (state_1->mixer.global_volume != state_2->mixer.global_volume)
+		return 0;
+
+	/* Compare ADSR envelopes */
+	for (uint8_t envelope = 0; envelope < ADSR_ENVELOPES; ++envelope) {
+		const Envelope_type_t *type_1 = &(state_1->adsr_envelopes[envelope]);
+		const Envelope_type_t *type_2 = &(state_2->adsr_envelopes[envelope]);
+		if (type_1->attack != type_2->attack || type_1->decay != type_2->decay
+				|| type_1->sustain_level != type_2->sustain_level || type_1->release != type_2->release)
+			return 0;
+	}
+
+	/* Compare channels (field by field, structure padding is not relevant) */
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		const Channel_t *channel_1 = &(state_1->mixer.channels[channel]);
+		const Channel_t *channel_2 = &(state_2->mixer.channels[channel]);
+		if (channel_1->volume != channel_2->volume)
+			return 0;
+#if OUTPUT_CHANNELS > 1
+		if (channel_1->pan != channel_2->pan)
+			return 0;
+#endif
+		if (channel_1->oscillator.waveform != channel_2->oscillator.waveform
+				|| channel_1->oscillator.duty != channel_2->oscillator.duty
+				|| channel_1->oscillator.tunning_word != channel_2->oscillator.tunning_word
+				|| channel_1->oscillator.phase_accumulator != channel_2->oscillator.phase_accumulator)
+			return 0;
+		if (channel_1->envelope.type != channel_2->envelope.type
+				|| channel_1->envelope.state != channel_2->envelope.state
+				|| channel_1->envelope.ended != channel_2->envelope.ended
+				|| channel_1->envelope.value != channel_2->envelope.value
+				|| !subtimer_equal(&(channel_1->envelope.value_change_timer), &(channel_2->envelope.value_change_timer)))
+			return 0;
+	}
+
+#ifdef INSTRUMENT_BANK
+	/* Compare instruments */
+	for (uint8_t instrument = 0; instrument < INSTRUMENTS; ++instrument) {
+		const Instrument_t *instrument_1 = &(state_1->instruments[instrument]);
+		const Instrument_t *instrument_2 = &(state_2->instruments[instrument]);
+		if (instrument_1->waveform != instrument_2->waveform || instrument_1->duty != instrument_2->duty
+				|| instrument_1->volume != instrument_2->volume || instrument_1->envelope != instrument_2->envelope)
+			return 0;
+	}
+#endif
+
+#ifdef VOICE_POOL
+	/* Compare voice pool */
+	const Voice_pool_t *pool_1 = &(state_1->voice_pool);
+	const Voice_pool_t *pool_2 = &(state_2->voice_pool);
+	if (pool_1->notes != pool_2->notes || pool_1->size != pool_2->size)
+		return 0;
+	for (uint8_t channel = 0; channel < VOICE_LOGICAL_CHANNELS; ++channel) {
+		const Logical_channel_t *logical_1 = &(pool_1->channels[channel]);
+		const Logical_channel_t *logical_2 = &(pool_2->channels[channel]);
+		if (logical_1->voice != logical_2->voice || logical_1->waveform != logical_2->waveform
+				|| logical_1->duty != logical_2->duty || logical_1->volume != logical_2->volume
+				|| logical_1->envelope != logical_2->envelope || logical_1->pan != logical_2->pan)
+			return 0;
+#ifdef MODULATION
+		if (!modulator_settings_equal(&(logical_1->modulation), &(logical_2->modulation)))
+			return 0;
+#endif
+	}
+	for (uint8_t voice = 0; voice < NUMBERS_OF_CHANNEL; ++voice) {
+		if (pool_1->owners[voice] != pool_2->owners[voice] || pool_1->released[voice] != pool_2->released[voice]
+				|| pool_1->stamps[voice] != pool_2->stamps[voice])
+			return 0;
+	}
+#endif
+
+#ifdef MODULATION
+	/* Compare modulators */
+	if (state_1->modulation.phase != state_2->modulation.phase)
+		return 0;
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		const Modulator_t *modulator_1 = &(state_1->modulation.channels[channel]);
+		const Modulator_t *modulator_2 = &(state_2->modulation.channels[channel]);
+		if (!modulator_settings_equal(&(modulator_1->settings), &(modulator_2->settings)))
+			return 0;
+		if (modulator_1->pitch != modulator_2->pitch || modulator_1->target != modulator_2->target
+				|| modulator_1->note != modulator_2->note || modulator_1->tuning != modulator_2->tuning
+				|| modulator_1->duty != modulator_2->duty || modulator_1->duty_applied != modulator_2->duty_applied
+				|| modulator_1->vibrato_phase != modulator_2->vibrato_phase || modulator_1->pwm_phase != modulator_2->pwm_phase
+				|| modulator_1->arpeggio_step != modulator_2->arpeggio_step
+				|| modulator_1->arpeggio_counter != modulator_2->arpeggio_counter)
+			return 0;
+	}
+#endif
+
+	return 1;
+}
+
+void render_start(Render_session_t *session, const Render_limits_t *limits) {
+	engine_reset();
+	tracker_fetch_execute(); // Same startup sequence as main()
+	session->limits = *limits;
+	session->position = 0;
+	session->status = RENDER_OK;
+}
+
+/* Render samples of a session, and stems if not NULL */
+static inline uint32_t render_session(Render_session_t *session, uint8_t *buffer, uint8_t *const *stems, uint32_t size) {
+	uint32_t count;
+
+	for (count = 0; count < size && session->status == RENDER_OK; ++count) {
+
+		/* Check duration */
+		if (session->limits.max_samples && session->position >= session->limits.max_samples) {
+			session->status = RENDER_DURATION_LIMIT;
+			break;
+		}
+
+		/* Render sample, drop it if it start the end of the song */
+		uint8_t sample = mixer_render_sample();
+		if (tracker_end_of_stream) {
+			session->status = RENDER_END_OF_STREAM;
+			break;
+		}
+		if (session->limits.max_loops && tracker_loop_count >= session->limits.max_loops) {
+			session->status = RENDER_LOOP_LIMIT;
+			break;
+		}
+
+		buffer[count] = sample;
+#ifdef STEM_OUTPUT
+		if (stems) {
+			for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel)
+				if (stems[channel])
+					stems[channel][count] = mixer_stems[channel];
+		}
+#else
+		(void)stems;
+#endif
+		++(session->position);
+	}
+
+	return count;
+}
+
+uint32_t render_samples(Render_session_t *session, uint8_t *buffer, uint32_t size) {
+	return render_session(session, buffer, NULL, size);
+}
+
+#ifdef STEM_OUTPUT
+uint32_t render_stems(Render_session_t *session, uint8_t *buffer, uint8_t *const *stems, uint32_t size) {
+	return render_session(session, buffer, stems, size);
+}
+#endif
+
+uint8_t render_init(Render_t *render, uint32_t max_length) {
+	render->length = 0;
+	render->max_length = max_length;
+	render->checkpoints_count = 0;
+	render->samples = malloc(max_length);
+	render->checkpoints = malloc(((max_length + RENDER_CHECKPOINT_INTERVAL - 1) / RENDER_CHECKPOINT_INTERVAL) * sizeof(Render_checkpoint_t));
+	if (!render->samples || !render->checkpoints) {
+		render_free(render);
+		return 0;
+	}
+	return 1;
+}
+
+void render_free(Render_t *render) {
+	free(render->samples);
+	free(render->checkpoints);
+	render->samples = NULL;
+	render->checkpoints = NULL;
+	render->length = 0;
+	render->max_length = 0;
+	render->checkpoints_count = 0;
+}
+
+/* Render one interval from current engine state, return number of samples rendered */
+static uint32_t render_interval(Render_t *render, uint32_t interval) {
+	Render_checkpoint_t *checkpoint = render->checkpoints + interval;
+
+	/* Save checkpoint */
+	engine_save_state(&(checkpoint->state));
+	tracker_trace_reset();
+
+	/* Same startup sequence as main() */
+	if (interval == 0)
+		tracker_fetch_execute();
+
+	/* Render samples of interval */
+	uint32_t start = interval * RENDER_CHECKPOINT_INTERVAL;
+	uint32_t end = start + RENDER_CHECKPOINT_INTERVAL;
+	if (end > render->max_length)
+		end = render->max_length;
+	uint32_t position;
+	for (position = start; position < end; ++position) {
+		uint8_t sample = mixer_render_sample();
+		if (tracker_end_of_stream)
+			break;
+		render->samples[position] = sample;
+	}
+
+	/* Store range of tracker file read during interval */
+	checkpoint->fetch_low = tracker_trace_low;
+	checkpoint->fetch_high = tracker_trace_high;
+
+	return position - start;
+}
+
+/* Find first interval (starting from first) which read the edited range of tracker file */
+static uint32_t find_edited_interval(const Render_t *render, uint32_t first, uint16_t edit_first, uint16_t edit_last) {
+	for (; first < render->checkpoints_count; ++first) {
+		if (render->checkpoints[first].fetch_low <= edit_last && render->checkpoints[first].fetch_high >= edit_first)
+			break;
+	}
+	return first;
+}
+
+uint32_t render_song(Render_t *render) {
+
+	/* Start from power-on state */
+	engine_reset();
+	render->length = 0;
+	render->checkpoints_count = 0;
+
+	/* Render interval by interval */
+	while (!tracker_end_of_stream && render->length < render->max_length)
+		render->length += render_interval(render, render->checkpoints_count++);
+
+	return render->length;
+}
+
+uint32_t render_incremental(Render_t *render, uint16_t edit_first, uint16_t edit_last) {
+
+	/* Find first interval affected by the edit */
+	uint32_t interval = find_edited_interval(render, 0, edit_first, edit_last);
+	if (interval >= render->checkpoints_count)
+		return 0; // Edited bytes never read
+
+	/* Restart from checkpoint before the edit */
+	uint32_t old_length = render->length;
+	uint32_t old_count = render->checkpoints_count;
+	uint32_t rendered = 0;
+	engine_load_state(&(render->checkpoints[interval].state));
+	render->length = interval * RENDER_CHECKPOINT_INTERVAL;
+
+	for (;;) {
+
+		/* Render interval (overwrite previous render) */
+		uint32_t count = render_interval(render, interval++);
+		render->length += count;
+		rendered += count;
+		if (tracker_end_of_stream || render->length >= render->max_length)
+			break;
+
+		/* Check for convergence with previous render */
+		if (interval < old_count) {
+			Engine_state_t state;
+			engine_save_state(&state);
+			if (engine_state_equal(&state, &(render->checkpoints[interval].state))) {
+
+				/* Same state, previous samples are valid until the next read of edited bytes */
+				uint32_t next = find_edited_interval(render, interval, edit_first, edit_last);
+				if (next >= old_count) {
+					render->length = old_length;
+					render->checkpoints_count = old_count;
+					return rendered;
+				}
+
+				/* Skip valid intervals */
+				engine_load_state(&(render->checkpoints[next].state));
+				render->length = next * RENDER_CHECKPOINT_INTERVAL;
+				interval = next;
+			}
+		}
+	}
+
+	render->checkpoints_count = interval;
+	return rendered;
+}
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ * @file render.h
+ * @brief Generic digital chiptune generator - Offline renderer
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle render a tracker file into memory, without any timer.\n
+ * A render session return a status at END_OF_STREAM or when a duration or loop limit is reached,
+ * so a caller can render many songs (or N loops of a song) in the same process.\n
+ * Every RENDER_CHECKPOINT_INTERVAL samples the engine state is saved with the range of tracker file read during the interval.\n
+ * After an edit of the tracker file, only the intervals which read the edited bytes are rendered again,
+ * the render stop as soon as the engine state is the same as the previous render at a checkpoint.\n
+ * With STEM_OUTPUT defined, a session can render the post-gain signal of each channel (stems) with the mix in the same pass.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define RENDER_API in common.h to use this functions bundle (computer only), include modulation.h and voice.h before this file
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _RENDER_H_
+#define _RENDER_H_
+
+/**
+ * Engine state structure (everything the next samples depend on)
+ */
+typedef struct {
+	Mixer_t mixer;
+	Envelope_type_t adsr_envelopes[ADSR_ENVELOPES];
+	SubTimer_t tempo_timer;
+	uint16_t tracker_index;
+	uint16_t tracker_pending;
+	uint32_t noise_seed;
+#ifdef VOICE_POOL
+	Voice_pool_t voice_pool;
+#endif
+#ifdef INSTRUMENT_BANK
+	Instrument_t instruments[INSTRUMENTS];
+#endif
+#ifdef MODULATION
+	Modulation_t modulation;
+#endif
+} Engine_state_t;
+
+/**
+ * Render checkpoint structure
+ */
+typedef struct {
+	Engine_state_t state; // Engine state at the start of the interval
+	uint16_t fetch_low;   // Lowest tracker file address read during the interval
+	uint16_t fetch_high;  // Highest tracker file address read during the interval
+} Render_checkpoint_t;
+
+/**
+ * Render structure
+ */
+typedef struct {
+	uint8_t *samples;
+	uint32_t length;
+	uint32_t max_length;
+	Render_checkpoint_t *checkpoints;
+	uint32_t checkpoints_count;
+} Render_t;
+
+/**
+ * Render status
+ */
+typedef enum {
+	RENDER_OK,            // More samples to render
+	RENDER_END_OF_STREAM, // END_OF_STREAM reached
+	RENDER_LOOP_LIMIT,    // Maximum number of loops reached
+	RENDER_DURATION_LIMIT // Maximum duration reached
+} Render_status_t;
+
+/**
+ * Render limits structure (0 for no limit)
+ */
+typedef struct {
+	uint32_t max_samples; // Maximum duration (in samples)
+	uint16_t max_loops;   // Maximum number of loops of tracker file
+} Render_limits_t;
+
+/**
+ * Render session structure
+ */
+typedef struct {
+	Render_limits_t limits;
+	uint32_t position; // Number of samples rendered since start of session
+	uint8_t status;
+} Render_session_t;
+
+/**
+ * Reset the whole engine to its power-on state
+ */
+void engine_reset(void);
+
+/**
+ * Save engine state
+ *
+ * @param state Pointer to an Engine_state_t object
+ */
+void engine_save_state(Engine_state_t *state);
+
+/**
+ * Restore engine state
+ *
+ * @param state Pointer to an Engine_state_t object
+ */
+void engine_load_state(const Engine_state_t *state);
+
+/**
+ * Compare two engine states
+ *
+ * @param state_1 Pointer to an Engine_state_t object
+ * @param state_2 Pointer to an Engine_state_t object
+ * @return 1 if both states will produce the same samples, 0 otherwise
+ */
+uint8_t engine_state_equal(const Engine_state_t *state_1, const Engine_state_t *state_2);
+
+/**
+ * Start a render session (reset engine and execute startup opcode)
+ *
+ * @param session Pointer to a Render_session_t object
+ * @param limits Pointer to a Render_limits_t object
+ */
+void render_start(Render_session_t *session, const Render_limits_t *limits);
+
+/**
+ * Render samples of a session
+ *
+ * @param session Pointer to a Render_session_t object
+ * @param buffer Output buffer (8 bits unsigned samples)
+ * @param size Size of output buffer (in samples)
+ * @return Number of samples rendered, less than size if session status is not RENDER_OK anymore
+ */
+uint32_t render_samples(Render_session_t *session, uint8_t *buffer, uint32_t size);
+
+#ifdef STEM_OUTPUT
+/**
+ * Render samples of a session and the stem of each channel in the same pass
+ *
+ * @param session Pointer to a Render_session_t object
+ * @param buffer Output buffer (8 bits unsigned samples, same as render_samples())
+ * @param stems Output buffer of each channel (NUMBERS_OF_CHANNEL pointers, 8 bits unsigned post-gain samples, see mixer_stems), NULL to skip a channel
+ * @param size Size of output buffers (in samples)
+ * @return Number of samples rendered, less than size if session status is not RENDER_OK anymore
+ */
+uint32_t render_stems(Render_session_t *session, uint8_t *buffer, uint8_t *const *stems, uint32_t size);
+#endif
+
+/**
+ * Allocate a Render object
+ *
+ * @param render Pointer to a Render_t object
+ * @param max_length Maximum length of render in samples
+ * @return 1 on success, 0 if out of memory
+ */
+uint8_t render_init(Render_t *render, uint32_t max_length);
+
+/**
+ * Free a Render object
+ *
+ * @param render Pointer to a Render_t object
+ */
+void render_free(Render_t *render);
+
+/**
+ * Render the whole tracker file (until END_OF_STREAM or max length)
+ *
+ * @param render Pointer to a Render_t object
+ * @return Length of render in samples
+ */
+uint32_t render_song(Render_t *render);
+
+/**
+ * Update a previous render after an edit of the tracker file
+ *
+ * @param render Pointer to a Render_t object (previous render of the tracker file)
+ * @param edit_first First edited address of tracker file
+ * @param edit_last Last edited address of tracker file
+ * @return Number of samples rendered again
+ */
+uint32_t render_incremental(Render_t *render, uint16_t edit_first, uint16_t edit_last);
+
+#endif // _RENDER_H_
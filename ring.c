@@ -0,0 +1,128 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+
+#ifdef OUTPUT_SINK
+
+#include <stdlib.h>       // For malloc
+#include <time.h>         // For nanosleep
+#include "ring.h"         // For ring structure
+
+/* Wait before polling the ring again */
+static inline void ring_wait(void) {
+	const struct timespec period = { 0, RING_POLL_PERIOD_US * 1000UL };
+	nanosleep(&period, NULL);
+}
+
+uint8_t ring_init(Ring_t *ring, uint32_t depth, uint32_t block_size, uint32_t high_watermark, uint32_t low_watermark) {
+
+	/* Check watermarks */
+	if (!depth || !block_size || !high_watermark || high_watermark > depth || low_watermark >= high_watermark)
+		return 0;
+
+	/* Setup ring */
+	ring->block_size = block_size;
+	ring->depth = depth;
+	ring->high_watermark = high_watermark;
+	ring->low_watermark = low_watermark;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->closed = 0;
+	ring->throttled = 0;
+	ring->underruns = 0;
+	ring->throttles = 0;
+	ring->max_fill = 0;
+
+	/* Allocate blocks */
+	ring->buffer = malloc((size_t)depth * block_size);
+	ring->lengths = malloc(depth * sizeof(uint32_t));
+	if (!ring->buffer || !ring->lengths) {
+		ring_free(ring);
+		return 0;
+	}
+	return 1;
+}
+
+void ring_free(Ring_t *ring) {
+	free(ring->buffer);
+	free(ring->lengths);
+	ring->buffer = NULL;
+	ring->lengths = NULL;
+}
+
+uint8_t *ring_acquire_write(Ring_t *ring) {
+	uint32_t fill = ring_fill(ring);
+
+	/* Track ring usage */
+	if (fill > ring->max_fill)
+		ring->max_fill = fill;
+
+	/* Stop at high watermark : producer is ahead of consumer */
+	if (fill >= ring->high_watermark) {
+		ring->throttled = 1;
+		__atomic_add_fetch(&(ring->throttles), 1, __ATOMIC_RELAXED);
+	}
+
+	/* Restart at low watermark */
+	while (ring->throttled) {
+		ring_wait();
+		if (ring_fill(ring) <= ring->low_watermark)
+			ring->throttled = 0;
+	}
+
+	return ring->buffer + (size_t)(ring->head % ring->depth) * ring->block_size;
+}
+
+void ring_commit_write(Ring_t *ring, uint32_t length) {
+	ring->lengths[ring->head % ring->depth] = length;
+	__atomic_store_n(&(ring->head), ring->head + 1, __ATOMIC_RELEASE);
+}
+
+void ring_close(Ring_t *ring) {
+	__atomic_store_n(&(ring->closed), 1, __ATOMIC_RELEASE);
+}
+
+const uint8_t *ring_acquire_read(Ring_t *ring, uint32_t *length) {
+
+	/* Wait for a block */
+	if (!ring_fill(ring)) {
+		if (__atomic_load_n(&(ring->closed), __ATOMIC_ACQUIRE) && !ring_fill(ring))
+			return NULL;
+
+		/* Empty ring : consumer is ahead of producer */
+		__atomic_add_fetch(&(ring->underruns), 1, __ATOMIC_RELAXED);
+		do {
+			ring_wait();
+			if (__atomic_load_n(&(ring->closed), __ATOMIC_ACQUIRE) && !ring_fill(ring))
+				return NULL;
+		} while (!ring_fill(ring));
+	}
+
+	uint32_t slot = ring->tail % ring->depth;
+	*length = ring->lengths[slot];
+	return ring->buffer + (size_t)slot * ring->block_size;
+}
+
+void ring_release_read(Ring_t *ring) {
+	__atomic_store_n(&(ring->tail), ring->tail + 1, __ATOMIC_RELEASE);
+}
+
+#endif
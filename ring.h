@@ -0,0 +1,133 @@
+/**
+ * @file ring.h
+ * @brief Generic digital chiptune generator - Single producer / single consumer ring buffer
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle implement a lock-free ring of sample blocks between one producer thread (render)
+ * and one consumer thread (output).\n
+ * The producer stop at the high watermark and restart at the low watermark, so it render in bursts of large blocks.\n
+ * Underrun (consumer waiting on an empty ring) and throttle (producer waiting at the high watermark, normal when render is faster than output) are counted.\n
+ * The producer never find the ring full (high watermark <= depth), so there is no overrun.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Only compiled when the port header define OUTPUT_SINK (POSIX system only)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _RING_H_
+#define _RING_H_
+
+/**
+ * Polling period of a waiting thread (in microseconds)
+ */
+#define RING_POLL_PERIOD_US 200
+
+/**
+ * Ring structure
+ *
+ * @remarks head is only written by the producer, tail only by the consumer
+ */
+typedef struct {
+	uint8_t *buffer;         // depth * block_size bytes
+	uint32_t *lengths;       // Length of each block
+	uint32_t block_size;     // Size of one block (in bytes)
+	uint32_t depth;          // Number of blocks
+	uint32_t high_watermark; // Producer stop when this number of blocks are ready
+	uint32_t low_watermark;  // Producer restart when this number of blocks are ready
+	uint32_t head;           // Number of blocks written (producer)
+	uint32_t tail;           // Number of blocks read (consumer)
+	uint8_t closed;          // Set by producer when no more blocks will be written
+	uint8_t throttled;       // Producer is waiting for the low watermark
+	uint32_t underruns;      // Number of time the consumer found the ring empty
+	uint32_t throttles;      // Number of time the producer was throttled (high watermark reached, wait for the low watermark)
+	uint32_t max_fill;       // Maximum number of ready blocks seen by the producer
+} Ring_t;
+
+/**
+ * Allocate a Ring object
+ *
+ * @param ring Pointer to a Ring_t object
+ * @param depth Number of blocks
+ * @param block_size Size of one block (in bytes)
+ * @param high_watermark Producer stop when this number of blocks are ready (1 to depth)
+ * @param low_watermark Producer restart when this number of blocks are ready (0 to high_watermark - 1)
+ * @return 1 on success, 0 on error
+ */
+uint8_t ring_init(Ring_t *ring, uint32_t depth, uint32_t block_size, uint32_t high_watermark, uint32_t low_watermark);
+
+/**
+ * Free a Ring object
+ *
+ * @param ring Pointer to a Ring_t object
+ */
+void ring_free(Ring_t *ring);
+
+/**
+ * Get number of ready blocks
+ *
+ * @param ring Pointer to a Ring_t object
+ * @return Number of blocks written and not yet read
+ */
+static inline uint32_t ring_fill(Ring_t *ring) {
+	return __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE) - __atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Get next free block (producer side, wait according watermarks)
+ *
+ * @param ring Pointer to a Ring_t object
+ * @return Pointer to a block of block_size bytes
+ */
+uint8_t *ring_acquire_write(Ring_t *ring);
+
+/**
+ * Publish block previously returned by ring_acquire_write() (producer side)
+ *
+ * @param ring Pointer to a Ring_t object
+ * @param length Number of bytes written in block
+ */
+void ring_commit_write(Ring_t *ring, uint32_t length);
+
+/**
+ * Close ring, no more blocks will be written (producer side)
+ *
+ * @param ring Pointer to a Ring_t object
+ */
+void ring_close(Ring_t *ring);
+
+/**
+ * Get next ready block (consumer side, wait if ring is empty)
+ *
+ * @param ring Pointer to a Ring_t object
+ * @param length Pointer to store number of bytes in block
+ * @return Pointer to block, NULL if ring is closed and empty
+ */
+const uint8_t *ring_acquire_read(Ring_t *ring, uint32_t *length);
+
+/**
+ * Release block previously returned by ring_acquire_read() (consumer side)
+ *
+ * @param ring Pointer to a Ring_t object
+ */
+void ring_release_read(Ring_t *ring);
+
+#endif // _RING_H_
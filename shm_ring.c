@@ -0,0 +1,217 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+
+#ifdef __linux__
+
+#include <string.h>       // For memcpy
+#include <limits.h>       // For INT_MAX
+#include <errno.h>        // For ESRCH
+#include <signal.h>       // For kill
+#include <time.h>         // For timespec
+#include <fcntl.h>        // For O_* constants
+#include <unistd.h>       // For ftruncate
+#include <sys/mman.h>     // For shm_open and mmap
+#include <sys/syscall.h>  // For SYS_futex
+#include <linux/futex.h>  // For FUTEX_WAIT
+#include "shm_ring.h"     // For shared memory ring structure
+
+/* Sleep while *address == value (shared between processes) */
+static inline void futex_wait(uint32_t *address, uint32_t value) {
+	syscall(SYS_futex, address, FUTEX_WAIT, value, NULL, NULL, 0);
+}
+
+/* Sleep while *address == value, at most timeout_ms, return 0 on timeout */
+static inline uint8_t futex_wait_timeout(uint32_t *address, uint32_t value, uint32_t timeout_ms) {
+	struct timespec timeout = { timeout_ms / 1000, (timeout_ms % 1000) * 1000000L };
+	return !(syscall(SYS_futex, address, FUTEX_WAIT, value, &timeout, NULL, 0) < 0 && errno == ETIMEDOUT);
+}
+
+/* Check consumer process (not attached yet counts as alive) */
+static inline uint8_t consumer_alive(Shm_ring_header_t *header) {
+	pid_t pid = __atomic_load_n(&(header->consumer_pid), __ATOMIC_ACQUIRE);
+	return !pid || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/* Wake all waiters of address */
+static inline void futex_wake(uint32_t *address) {
+	syscall(SYS_futex, address, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/* Map shared memory object */
+static uint8_t shm_ring_map(Shm_ring_t *ring, int fd, uint32_t mapping_size) {
+	void *mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return 0;
+	ring->header = mapping;
+	ring->data = (uint8_t *)mapping + sizeof(Shm_ring_header_t);
+	ring->mapping_size = mapping_size;
+	return 1;
+}
+
+uint8_t shm_ring_create(Shm_ring_t *ring, const char *name, uint32_t size, uint32_t sample_rate, uint8_t channels, uint8_t bits_per_sample) {
+
+	/* Check size (power of two) */
+	if (!size || (size & (size - 1)))
+		return 0;
+
+	/* Create shared memory object */
+	uint32_t mapping_size = sizeof(Shm_ring_header_t) + size;
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0)
+		return 0;
+	if (ftruncate(fd, mapping_size)) {
+		close(fd);
+		shm_ring_unlink(name);
+		return 0;
+	}
+	if (!shm_ring_map(ring, fd, mapping_size)) {
+		shm_ring_unlink(name);
+		return 0;
+	}
+	ring->owner = 1;
+
+	/* Setup header (magic last, consumer check it) */
+	Shm_ring_header_t *header = ring->header;
+	header->version = SHM_RING_VERSION;
+	header->sample_rate = sample_rate;
+	header->channels = channels;
+	header->bits_per_sample = bits_per_sample;
+	header->closed = 0;
+	header->size = size;
+	header->write_index = 0;
+	header->read_index = 0;
+	header->data_sequence = 0;
+	header->consumer_pid = 0;
+	__atomic_store_n(&(header->magic), SHM_RING_MAGIC, __ATOMIC_RELEASE);
+	return 1;
+}
+
+uint8_t shm_ring_open(Shm_ring_t *ring, const char *name) {
+
+	/* Open shared memory object */
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+		return 0;
+	off_t mapping_size = lseek(fd, 0, SEEK_END);
+	if (mapping_size < (off_t)sizeof(Shm_ring_header_t)) {
+		close(fd);
+		return 0;
+	}
+	if (!shm_ring_map(ring, fd, mapping_size))
+		return 0;
+	ring->owner = 0;
+
+	/* Check header */
+	Shm_ring_header_t *header = ring->header;
+	if (__atomic_load_n(&(header->magic), __ATOMIC_ACQUIRE) != SHM_RING_MAGIC || header->version != SHM_RING_VERSION
+			|| sizeof(Shm_ring_header_t) + header->size != ring->mapping_size) {
+		munmap(header, ring->mapping_size);
+		return 0;
+	}
+	__atomic_store_n(&(header->consumer_pid), getpid(), __ATOMIC_RELEASE);
+	return 1;
+}
+
+uint8_t shm_ring_write(Shm_ring_t *ring, const uint8_t *data, uint32_t length) {
+	Shm_ring_header_t *header = ring->header;
+	uint32_t size = header->size;
+	uint32_t write_index = header->write_index;
+	uint32_t waited_ms = 0;
+
+	while (length) {
+
+		/* Wait for free space, give up on dead or stuck consumer */
+		uint32_t read_index = __atomic_load_n(&(header->read_index), __ATOMIC_ACQUIRE);
+		uint32_t space = size - (write_index - read_index);
+		if (!space) {
+			if (waited_ms >= SHM_RING_TIMEOUT_MS || !consumer_alive(header))
+				return 0;
+			if (!futex_wait_timeout(&(header->read_index), read_index, SHM_RING_POLL_MS))
+				waited_ms += SHM_RING_POLL_MS;
+			continue;
+		}
+		waited_ms = 0;
+
+		/* Copy contiguous part */
+		uint32_t offset = write_index & (size - 1);
+		uint32_t count = size - offset;
+		if (count > space)
+			count = space;
+		if (count > length)
+			count = length;
+		memcpy(ring->data + offset, data, count);
+		data += count;
+		length -= count;
+		write_index += count;
+
+		/* Publish samples and wake consumer */
+		__atomic_store_n(&(header->write_index), write_index, __ATOMIC_RELEASE);
+		__atomic_add_fetch(&(header->data_sequence), 1, __ATOMIC_RELEASE);
+		futex_wake(&(header->data_sequence));
+	}
+	return 1;
+}
+
+const uint8_t *shm_ring_peek(Shm_ring_t *ring, uint32_t *length) {
+	Shm_ring_header_t *header = ring->header;
+	uint32_t size = header->size;
+	uint32_t read_index = header->read_index;
+
+	for (;;) {
+
+		/* Sequence first, so a write or close after the checks wake us */
+		uint32_t sequence = __atomic_load_n(&(header->data_sequence), __ATOMIC_ACQUIRE);
+		uint32_t available = __atomic_load_n(&(header->write_index), __ATOMIC_ACQUIRE) - read_index;
+		if (available) {
+			uint32_t offset = read_index & (size - 1);
+			*length = (size - offset < available) ? size - offset : available;
+			return ring->data + offset;
+		}
+		if (__atomic_load_n(&(header->closed), __ATOMIC_ACQUIRE))
+			return NULL;
+		futex_wait(&(header->data_sequence), sequence);
+	}
+}
+
+void shm_ring_consume(Shm_ring_t *ring, uint32_t length) {
+	Shm_ring_header_t *header = ring->header;
+	__atomic_store_n(&(header->read_index), header->read_index + length, __ATOMIC_RELEASE);
+	futex_wake(&(header->read_index));
+}
+
+void shm_ring_close(Shm_ring_t *ring) {
+	Shm_ring_header_t *header = ring->header;
+	if (ring->owner) {
+		__atomic_store_n(&(header->closed), 1, __ATOMIC_RELEASE);
+		__atomic_add_fetch(&(header->data_sequence), 1, __ATOMIC_RELEASE);
+		futex_wake(&(header->data_sequence));
+	} else
+		__atomic_store_n(&(header->consumer_pid), 0, __ATOMIC_RELEASE);
+	munmap(header, ring->mapping_size);
+	ring->header = NULL;
+	ring->data = NULL;
+}
+
+void shm_ring_unlink(const char *name) {
+	shm_unlink(name);
+}
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file shm_ring.h
+ * @brief Generic digital chiptune generator - Shared memory sample ring
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle share rendered samples with another process through a POSIX shared memory object.\n
+ * The shared memory start with a small header (format, write and read indices) followed by the sample ring.\n
+ * Producer and consumer sleep on futex when the ring is full / empty.
+ * The producer give up when the ring stay full for SHM_RING_TIMEOUT_MS or when the consumer process is dead (consumer PID in the header).
+ * The consumer read samples directly in the shared memory (zero copy).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Linux only (shm_open, mmap and futex), link with -lrt on old glibc
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _SHM_RING_H_
+#define _SHM_RING_H_
+
+/* Dependency */
+#include <stdint.h> // For hardcoded type
+
+/**
+ * Shared memory header magic ("CHPT")
+ */
+#define SHM_RING_MAGIC 0x54504843UL
+
+/**
+ * Shared memory layout version
+ */
+#define SHM_RING_VERSION 2
+
+/**
+ * Default size of sample ring (in bytes, must be a power of two)
+ */
+#define SHM_RING_DEFAULT_SIZE 1048576UL
+
+/**
+ * Producer wait timeout on a full ring (in ms, consumer stuck or not attached)
+ */
+#define SHM_RING_TIMEOUT_MS 5000
+
+/**
+ * Producer wait period between two consumer checks (in ms)
+ */
+#define SHM_RING_POLL_MS 100
+
+/**
+ * Shared memory header structure
+ *
+ * @remarks write_index and read_index count bytes since start of stream (modulo 2^32)
+ */
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t sample_rate;
+	uint8_t channels;
+	uint8_t bits_per_sample;
+	uint8_t closed;          // Set by producer at end of stream
+	uint8_t reserved;
+	uint32_t size;           // Size of sample ring (in bytes)
+	uint32_t write_index;    // Written by producer only
+	uint32_t read_index;     // Written by consumer only (futex word of producer)
+	uint32_t data_sequence;  // Incremented by producer on write and close (futex word of consumer)
+	uint32_t consumer_pid;   // Set by consumer on open, 0 if no consumer
+} Shm_ring_header_t;
+
+/**
+ * Shared memory ring handle structure
+ */
+typedef struct Shm_ring_s {
+	Shm_ring_header_t *header;
+	uint8_t *data;
+	uint32_t mapping_size;
+	uint8_t owner; // 1 for producer, 0 for consumer
+} Shm_ring_t;
+
+/**
+ * Create a shared memory ring (producer side)
+ *
+ * @param ring Pointer to a Shm_ring_t object
+ * @param name Name of shared memory object (like "/chiptune")
+ * @param size Size of sample ring (in bytes, power of two)
+ * @param sample_rate Sample rate of stream
+ * @param channels Number of channels of stream
+ * @param bits_per_sample Number of bits per sample of stream
+ * @return 1 on success, 0 on error
+ */
+uint8_t shm_ring_create(Shm_ring_t *ring, const char *name, uint32_t size, uint32_t sample_rate, uint8_t channels, uint8_t bits_per_sample);
+
+/**
+ * Open an existing shared memory ring (consumer side)
+ *
+ * @param ring Pointer to a Shm_ring_t object
+ * @param name Name of shared memory object
+ * @return 1 on success, 0 on error
+ */
+uint8_t shm_ring_open(Shm_ring_t *ring, const char *name);
+
+/**
+ * Write samples into ring (producer side, wait if ring is full)
+ *
+ * @param ring Pointer to a Shm_ring_t object
+ * @param data Pointer to samples
+ * @param length Number of bytes to write
+ * @return 1 on success, 0 if the consumer is dead or did not read for SHM_RING_TIMEOUT_MS
+ */
+uint8_t shm_ring_write(Shm_ring_t *ring, const uint8_t *data, uint32_t length);
+
+/**
+ * Get readable samples in place (consumer side, wait if ring is empty)
+ *
+ * @param ring Pointer to a Shm_ring_t object
+ * @param length Pointer to store number of contiguous readable bytes
+ * @return Pointer to samples in shared memory, NULL at end of stream
+ */
+const uint8_t *shm_ring_peek(Shm_ring_t *ring, uint32_t *length);
+
+/**
+ * Release samples returned by shm_ring_peek() (consumer side)
+ *
+ * @param ring Pointer to a Shm_ring_t object
+ * @param length Number of bytes consumed
+ */
+void shm_ring_consume(Shm_ring_t *ring, uint32_t length);
+
+/**
+ * Close a shared memory ring (producer side : mark end of stream, consumer side : detach)
+ *
+ * @param ring Pointer to a Shm_ring_t object
+ * @remarks The shared memory object is not unlinked, the consumer do it with shm_ring_unlink()
+ */
+void shm_ring_close(Shm_ring_t *ring);
+
+/**
+ * Remove shared memory object name
+ *
+ * @param name Name of shared memory object
+ */
+void shm_ring_unlink(const char *name);
+
+#endif // _SHM_RING_H_
@@ -0,0 +1,177 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+
+#ifdef SIMULATION_PORT
+
+#include <stdio.h>        // For fprintf
+#include <time.h>         // For clock_gettime
+#include "sink.h"         // For output sink
+#include "simulation.h"   // For simulation structure
+
+/* Simulation statistics */
+Simulation_stats_t simulation_stats;
+
+/* Simulated timer */
+static uint32_t sample_rate;
+static uint64_t interrupt_index;  // Sample period of current interrupt
+static uint64_t isr_start;        // Simulated start time of current interrupt
+static uint64_t busy_until;       // Simulated end time of previous interrupt
+static uint64_t host_start;       // Host time at start of current interrupt
+
+/* Simulated DAC */
+static uint16_t dac_value;        // Held DAC output (16 bits, unsigned)
+static uint8_t dac_fresh;         // DAC written since last output sample
+static uint64_t output_index;     // Sample period of next output sample
+
+/* Timing file */
+static FILE *timing_file;
+
+/* Jitter generator (xorshift) */
+static uint32_t random_state = SIM_SEED;
+
+static inline uint32_t next_random(void) {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+/* Get host CPU time of calling thread in nanoseconds (time while descheduled is not counted) */
+static inline uint64_t host_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/* Get due time of a sample period */
+static inline uint64_t due_time(uint64_t index) {
+	return (index * 1000000000ULL) / sample_rate;
+}
+
+/* Output DAC value at end of each sample period until time */
+static void output_until(uint64_t time) {
+	while (due_time(output_index + 1) < time) {
+		if (!dac_fresh)
+			++simulation_stats.repeated;
+#if OUTPUT_SAMPLE_BITS == 8
+		sink_put(&output_sink, dac_value >> 8);
+#else
+		uint16_t sample = dac_value ^ 0x8000; // Signed, little-endian
+		sink_put(&output_sink, low(sample));
+		sink_put(&output_sink, high(sample));
+#endif
+		dac_fresh = 0;
+		++output_index;
+	}
+}
+
+uint8_t simulation_start(uint32_t rate) {
+	sample_rate = rate;
+	interrupt_index = 0;
+	busy_until = 0;
+	dac_value = 0;
+	dac_fresh = 0;
+	output_index = 0;
+	simulation_stats = (Simulation_stats_t) { 0 };
+#ifdef SIM_TIMING_FILENAME
+	timing_file = fopen(SIM_TIMING_FILENAME, "w");
+	if (timing_file == NULL)
+		return 0;
+	fprintf(timing_file, "sample,due_ns,start_ns,dac_ns,lateness_ns,dac_code\n");
+#endif
+	return 1;
+}
+
+void simulation_isr_enter(void) {
+
+	/* Interrupts due while the previous one was running share one pending flag */
+	while (due_time(interrupt_index + 1) < busy_until) {
+		++interrupt_index;
+		++simulation_stats.lost;
+	}
+
+	/* Interrupt latency */
+	uint64_t start = due_time(interrupt_index);
+	if (SIM_JITTER_NS)
+		start += next_random() % (SIM_JITTER_NS + 1);
+	isr_start = (start > busy_until) ? start : busy_until;
+	host_start = host_time_ns();
+}
+
+void simulation_dac_write(uint16_t sample) {
+
+	/* Duration of interrupt on the target */
+	uint64_t duration = SIM_ISR_COST_NS;
+	if (duration == 0)
+		duration = ((host_time_ns() - host_start) * CPU_SLOWDOWN_PERCENT) / SIM_CPU_BUDGET_PERCENT;
+	uint64_t write_time = isr_start + duration;
+	busy_until = write_time;
+
+	/* Lateness */
+	uint64_t due = due_time(interrupt_index);
+	++simulation_stats.interrupts;
+	simulation_stats.busy_sum += duration;
+	simulation_stats.lateness_sum += write_time - due;
+	if (write_time - due > simulation_stats.lateness_max)
+		simulation_stats.lateness_max = write_time - due;
+	if (write_time > due_time(interrupt_index + 1))
+		++simulation_stats.late;
+
+	/* DAC resolution */
+	uint16_t code = sample >> (16 - SIM_DAC_BITS);
+	if (timing_file)
+		fprintf(timing_file, "%llu,%llu,%llu,%llu,%llu,%u\n", (unsigned long long)interrupt_index,
+				(unsigned long long)due, (unsigned long long)isr_start, (unsigned long long)write_time,
+				(unsigned long long)(write_time - due), code);
+
+	/* Output held value, then latch new value */
+	output_until(write_time);
+	if (dac_fresh)
+		++simulation_stats.dropped;
+	dac_value = code << (16 - SIM_DAC_BITS);
+	dac_fresh = 1;
+	++interrupt_index;
+}
+
+void simulation_stop(void) {
+
+	/* Last DAC value */
+	if (dac_fresh)
+		output_until(due_time(output_index + 1) + 1);
+	if (timing_file) {
+		fclose(timing_file);
+		timing_file = NULL;
+	}
+
+	if (simulation_stats.interrupts == 0)
+		return;
+	fprintf(stderr, "simulation: %lu interrupts, %lu lost, %lu late, %lu repeated, %lu dropped samples (%u bits DAC)\n",
+			(unsigned long)simulation_stats.interrupts, (unsigned long)simulation_stats.lost,
+			(unsigned long)simulation_stats.late, (unsigned long)simulation_stats.repeated,
+			(unsigned long)simulation_stats.dropped, SIM_DAC_BITS);
+	fprintf(stderr, "simulation: lateness mean %.1f ns, max %llu ns, period %.1f ns, CPU load %.1f%%\n",
+			(double)simulation_stats.lateness_sum / simulation_stats.interrupts,
+			(unsigned long long)simulation_stats.lateness_max, 1e9 / sample_rate,
+			(100.0 * simulation_stats.busy_sum) / due_time(interrupt_index));
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file simulation.h
+ * @brief Generic digital chiptune generator - MCU timer and DAC simulation
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle simulate the sampling timer and the DAC of a MCU on computer (see the simulation port).\n
+ * Each sampling interrupt is due every 1 / SAMPLE_RATE of simulated time, it start after a random latency (jitter)
+ * or when the previous interrupt end, and last the measured render time scaled to the target CPU
+ * (CPU_SLOWDOWN_PERCENT, and SIM_CPU_BUDGET_PERCENT of the CPU left to the sampling interrupt by the application).\n
+ * Interrupts due while the previous one is still running are merged (one pending flag), the extra ones are lost.\n
+ * The DAC hold the last written value (quantized to SIM_DAC_BITS, up to 16), the output sink record the DAC output
+ * at the end of each sample period : late samples are repeated or dropped like on the real hardware.\n
+ * Statistics (lateness, late samples, lost interrupts, repeated and dropped samples) are printed on stderr at stop,
+ * the timing of each sample (due / start / DAC write time) can be written to a CSV file (SIM_TIMING_FILENAME).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Only compiled when the port header define SIMULATION_PORT
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _SIMULATION_H_
+#define _SIMULATION_H_
+
+/* Dependency */
+#include <stdint.h> // For hardcoded type
+
+/**
+ * Simulation statistics structure (times in nanoseconds of simulated time)
+ */
+typedef struct {
+	uint32_t interrupts;     // Number of executed sampling interrupts
+	uint32_t lost;           // Number of interrupts merged with a pending one
+	uint32_t late;           // Number of samples written to the DAC after the end of their period
+	uint32_t repeated;       // Number of output samples without a new DAC value (previous value held)
+	uint32_t dropped;        // Number of DAC values overwritten before being output
+	uint64_t lateness_sum;   // Sum of DAC write time - due time
+	uint64_t lateness_max;   // Highest DAC write time - due time
+	uint64_t busy_sum;       // Sum of interrupt durations
+} Simulation_stats_t;
+
+/**
+ * Simulation statistics
+ */
+extern Simulation_stats_t simulation_stats;
+
+/**
+ * Start the simulated sampling timer
+ *
+ * @param sample_rate Sampling rate frequency of output sound
+ * @return 1 on success, 0 on error (timing file)
+ */
+uint8_t simulation_start(uint32_t sample_rate);
+
+/**
+ * Enter the sampling interrupt (call at start of the ISR)
+ */
+void simulation_isr_enter(void);
+
+/**
+ * Write a sample to the simulated DAC (call at end of the ISR)
+ *
+ * @param sample Output sample (16 bits, unsigned), quantized to SIM_DAC_BITS
+ */
+void simulation_dac_write(uint16_t sample);
+
+/**
+ * Stop the simulated sampling timer, output the last DAC value and print statistics on stderr
+ */
+void simulation_stop(void);
+
+#endif // _SIMULATION_H_
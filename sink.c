@@ -0,0 +1,335 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+
+#ifdef OUTPUT_SINK
+
+#include <stdlib.h>       // For malloc
+#include <string.h>       // For memcpy
+#include <errno.h>        // For EINTR
+#include <fcntl.h>        // For open
+#include <unistd.h>       // For write
+#include "shm_ring.h"     // For shared memory ring
+#include "adpcm.h"        // For IMA-ADPCM encoder
+#include "sink.h"         // For sink structure
+
+/* Output sink of computer port */
+Sink_t output_sink;
+
+/* Size of WAV header */
+#define WAV_HEADER_SIZE 44
+
+/* Size of IMA-ADPCM WAV header (fmt chunk with samples per block, fact chunk) */
+#define ADPCM_HEADER_SIZE 60
+
+/* Number of input samples encoded per write of the ADPCM sink */
+#define ADPCM_CHUNK_SAMPLES (8 * ADPCM_SAMPLES_PER_BLOCK)
+
+/* Store a little-endian 16 bits value */
+static inline void put_le16(uint8_t *buffer, uint16_t value) {
+	buffer[0] = low(value);
+	buffer[1] = high(value);
+}
+
+/* Store a little-endian 32 bits value */
+static inline void put_le32(uint8_t *buffer, uint32_t value) {
+	put_le16(buffer, value & 0xFFFF);
+	put_le16(buffer + 2, value >> 16);
+}
+
+/* Build WAV header for given data length */
+static void build_wav_header(uint8_t *header, const Sink_format_t *format, uint32_t data_length) {
+	uint16_t block_align = format->channels * ((format->bits_per_sample + 7) / 8);
+	memcpy(header, "RIFF", 4);
+	put_le32(header + 4, 36 + data_length + (data_length & 1)); // Pad byte of odd data chunk
+	memcpy(header + 8, "WAVEfmt ", 8);
+	put_le32(header + 16, 16);                               // fmt chunk size
+	put_le16(header + 20, format->bits_per_sample == 32 ? 3 : 1); // IEEE float or PCM
+	put_le16(header + 22, format->channels);
+	put_le32(header + 24, format->sample_rate);
+	put_le32(header + 28, format->sample_rate * block_align);
+	put_le16(header + 32, block_align);
+	put_le16(header + 34, format->bits_per_sample);
+	memcpy(header + 36, "data", 4);
+	put_le32(header + 40, data_length);
+}
+
+/* Build IMA-ADPCM WAV header for given data length and number of samples */
+static void build_adpcm_header(uint8_t *header, const Sink_format_t *format, uint32_t data_length, uint32_t samples) {
+	memcpy(header, "RIFF", 4);
+	put_le32(header + 4, ADPCM_HEADER_SIZE - 8 + data_length);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	put_le32(header + 16, 20);                                  // fmt chunk size
+	put_le16(header + 20, 0x11);                                // IMA-ADPCM
+	put_le16(header + 22, 1);                                   // Mono
+	put_le32(header + 24, format->sample_rate);
+	put_le32(header + 28, ((uint64_t)format->sample_rate * ADPCM_BLOCK_ALIGN) / ADPCM_SAMPLES_PER_BLOCK);
+	put_le16(header + 32, ADPCM_BLOCK_ALIGN);
+	put_le16(header + 34, 4);                                   // Bits per sample
+	put_le16(header + 36, 2);                                   // Extra format bytes
+	put_le16(header + 38, ADPCM_SAMPLES_PER_BLOCK);
+	memcpy(header + 40, "fact", 4);
+	put_le32(header + 44, 4);
+	put_le32(header + 48, samples);
+	memcpy(header + 52, "data", 4);
+	put_le32(header + 56, data_length);
+}
+
+/* Write all bytes to file descriptor (handle partial write) */
+static uint8_t write_all(int fd, const uint8_t *data, uint32_t length) {
+	while (length) {
+		ssize_t count = write(fd, data, length);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			return 0;
+		}
+		data += count;
+		length -= count;
+	}
+	return 1;
+}
+
+uint8_t sink_open(Sink_t *sink, uint8_t type, const char *filename, const Sink_format_t *format) {
+
+	/* Reset sink */
+	memset(sink, 0, sizeof(Sink_t));
+	sink->type = type;
+	sink->fd = -1;
+	sink->format = *format;
+
+	/* Allocate aligned block buffer */
+	void *block;
+	if (posix_memalign(&block, 4096, SINK_BLOCK_SIZE))
+		return 0;
+	sink->block = block;
+
+	/* Open sink according its type */
+	switch (type) {
+	case SINK_NULL:
+		break;
+
+	case SINK_RAW:
+	case SINK_WAV:
+		sink->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (sink->fd < 0)
+			break;
+		if (type == SINK_WAV) {
+			uint8_t header[WAV_HEADER_SIZE];
+			build_wav_header(header, format, 0);
+			if (!write_all(sink->fd, header, WAV_HEADER_SIZE)) {
+				close(sink->fd);
+				sink->fd = -1;
+			}
+		}
+		break;
+
+	case SINK_STDOUT:
+		sink->fd = STDOUT_FILENO;
+		break;
+
+	case SINK_MEMORY:
+		sink->capacity = SINK_BLOCK_SIZE;
+		sink->memory = malloc(sink->capacity);
+		break;
+
+	case SINK_SHM:
+		sink->shm = malloc(sizeof(Shm_ring_t));
+		if (sink->shm && !shm_ring_create(sink->shm, filename, SHM_RING_DEFAULT_SIZE, format->sample_rate, format->channels, format->bits_per_sample)) {
+			free(sink->shm);
+			sink->shm = NULL;
+		}
+		break;
+
+	case SINK_ADPCM:
+		if (format->channels != 1 || (format->bits_per_sample != 8 && format->bits_per_sample != 16))
+			break;
+		sink->adpcm = malloc(sizeof(Adpcm_encoder_t));
+		if (!sink->adpcm)
+			break;
+		adpcm_encoder_init(sink->adpcm);
+		sink->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (sink->fd >= 0) {
+			uint8_t header[ADPCM_HEADER_SIZE];
+			build_adpcm_header(header, format, 0, 0);
+			if (!write_all(sink->fd, header, ADPCM_HEADER_SIZE)) {
+				close(sink->fd);
+				sink->fd = -1;
+			}
+		}
+		if (sink->fd < 0) {
+			free(sink->adpcm);
+			sink->adpcm = NULL;
+		}
+		break;
+	}
+
+	/* Check for error */
+	if ((type == SINK_MEMORY && !sink->memory) || (type == SINK_SHM && !sink->shm) || (type == SINK_ADPCM && !sink->adpcm)
+			|| ((type == SINK_RAW || type == SINK_WAV || type == SINK_STDOUT) && sink->fd < 0)) {
+		free(sink->block);
+		sink->block = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+/* Encode samples and write the completed ADPCM blocks, return 1 on success */
+static uint8_t adpcm_output(Sink_t *sink, const uint8_t *data, uint32_t length) {
+	uint8_t blocks[(ADPCM_CHUNK_SAMPLES / ADPCM_SAMPLES_PER_BLOCK + 1) * ADPCM_BLOCK_ALIGN];
+	int16_t samples[ADPCM_CHUNK_SAMPLES];
+
+	/* 16 bits samples are little-endian pairs of bytes (blocks of 16 bits output have an even length) */
+	uint8_t sample_size = sink->format.bits_per_sample / 8;
+	uint32_t count = length / sample_size;
+
+	for (uint32_t first = 0; first < count; first += ADPCM_CHUNK_SAMPLES) {
+		uint32_t chunk = (count - first < ADPCM_CHUNK_SAMPLES) ? count - first : ADPCM_CHUNK_SAMPLES;
+		uint32_t bytes;
+		if (sample_size == 1) {
+			bytes = adpcm_encode_u8(sink->adpcm, data + first, chunk, blocks);
+		} else {
+			for (uint32_t i = 0; i < chunk; ++i)
+				samples[i] = (int16_t)(data[2 * (first + i)] | (data[2 * (first + i) + 1] << 8));
+			bytes = adpcm_encode(sink->adpcm, samples, chunk, blocks);
+		}
+		if (bytes && !write_all(sink->fd, blocks, bytes)) {
+			sink->error = 1;
+			return 0;
+		}
+		sink->length += bytes;
+	}
+	return 1;
+}
+
+/* Write a block to the sink destination */
+static uint8_t sink_output(Sink_t *sink, const uint8_t *data, uint32_t length) {
+	switch (sink->type) {
+	case SINK_NULL:
+		break;
+
+	case SINK_RAW:
+	case SINK_WAV:
+	case SINK_STDOUT:
+		if (!write_all(sink->fd, data, length)) {
+			sink->error = 1;
+			return 0;
+		}
+		break;
+
+	case SINK_MEMORY:
+		if (sink->length + length > sink->capacity) {
+			uint32_t capacity = sink->capacity;
+			while (sink->length + length > capacity)
+				capacity *= 2;
+			uint8_t *memory = realloc(sink->memory, capacity);
+			if (!memory) {
+				sink->error = 1;
+				return 0;
+			}
+			sink->memory = memory;
+			sink->capacity = capacity;
+		}
+		memcpy(sink->memory + sink->length, data, length);
+		break;
+
+	case SINK_SHM:
+		if (sink->error || !shm_ring_write(sink->shm, data, length)) { // Consumer dead or stuck (once)
+			sink->error = 1;
+			return 0;
+		}
+		break;
+
+	case SINK_ADPCM:
+		return adpcm_output(sink, data, length); // Count encoded bytes
+	}
+	sink->length += length;
+	return 1;
+}
+
+uint8_t sink_flush(Sink_t *sink) {
+	uint32_t fill = sink->block_fill;
+	sink->block_fill = 0;
+	return fill ? sink_output(sink, sink->block, fill) : 1;
+}
+
+uint8_t sink_write(Sink_t *sink, const void *data, uint32_t length) {
+	if (!sink_flush(sink)) // Keep samples order
+		return 0;
+	return sink_output(sink, data, length);
+}
+
+void sink_close(Sink_t *sink) {
+
+	/* Flush pending samples */
+	if (sink->block)
+		sink_flush(sink);
+
+	/* Pad odd data chunk (RIFF chunks are word aligned), patch WAV header with final data length */
+	if (sink->type == SINK_WAV && sink->fd >= 0) {
+		const uint8_t pad = 0;
+		if ((sink->length & 1) && !write_all(sink->fd, &pad, 1))
+			sink->error = 1;
+		uint8_t header[WAV_HEADER_SIZE];
+		build_wav_header(header, &(sink->format), sink->length);
+		if (pwrite(sink->fd, header, WAV_HEADER_SIZE, 0) != WAV_HEADER_SIZE)
+			sink->error = 1;
+	}
+
+	/* Last ADPCM block, patch header with final data length and number of samples */
+	if (sink->type == SINK_ADPCM && sink->adpcm) {
+		uint8_t block[ADPCM_BLOCK_ALIGN];
+		uint32_t bytes = adpcm_flush(sink->adpcm, block);
+		if (bytes && write_all(sink->fd, block, bytes))
+			sink->length += bytes;
+		else if (bytes)
+			sink->error = 1;
+		uint8_t header[ADPCM_HEADER_SIZE];
+		build_adpcm_header(header, &(sink->format), sink->length, sink->adpcm->samples);
+		if (pwrite(sink->fd, header, ADPCM_HEADER_SIZE, 0) != ADPCM_HEADER_SIZE)
+			sink->error = 1;
+		free(sink->adpcm);
+		sink->adpcm = NULL;
+	}
+
+	/* Mark end of stream of shared memory ring */
+	if (sink->type == SINK_SHM && sink->shm) {
+		shm_ring_close(sink->shm);
+		free(sink->shm);
+		sink->shm = NULL;
+	}
+
+	/* Close file (but not stdout) */
+	if ((sink->type == SINK_RAW || sink->type == SINK_WAV || sink->type == SINK_ADPCM) && sink->fd >= 0)
+		close(sink->fd);
+	sink->fd = -1;
+
+	free(sink->block);
+	sink->block = NULL;
+}
+
+void sink_free_memory(Sink_t *sink) {
+	free(sink->memory);
+	sink->memory = NULL;
+	sink->capacity = 0;
+}
+
+#endif
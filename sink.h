@@ -0,0 +1,147 @@
+/**
+ * @file sink.h
+ * @brief Generic digital chiptune generator - Output sinks
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle handle output of rendered samples on computer ports.\n
+ * A sink accept whole blocks of samples, single samples are gathered in an aligned block buffer
+ * and written with one system call per SINK_BLOCK_SIZE bytes.\n
+ * Available sinks : raw file, WAV file (header patched at close), IMA-ADPCM WAV file (mono 8 or 16 bits samples
+ * encoded on the fly, see adpcm.h), stdout / pipe, memory buffer, shared memory ring (see shm_ring.h) and null (for benchmark).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Only compiled when the port header define OUTPUT_SINK (POSIX system only)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _SINK_H_
+#define _SINK_H_
+
+/* Dependency */
+#include <stdint.h> // For hardcoded type
+
+/**
+ * Size of sink block buffer (in bytes)
+ */
+#define SINK_BLOCK_SIZE 65536UL
+
+/**
+ * Sink types
+ */
+typedef enum {
+	SINK_NULL,
+	SINK_RAW,
+	SINK_WAV,
+	SINK_STDOUT,
+	SINK_MEMORY,
+	SINK_SHM,
+	SINK_ADPCM
+} Sink_type_t;
+
+/**
+ * Sample format structure (used by WAV header)
+ */
+typedef struct {
+	uint32_t sample_rate;
+	uint8_t channels;
+	uint8_t bits_per_sample;
+} Sink_format_t;
+
+/**
+ * Sink structure
+ */
+typedef struct Sink_s {
+	uint8_t type;
+	int fd;                // File descriptor (raw, WAV and stdout sinks)
+	uint8_t *block;        // Aligned block buffer for single samples
+	uint32_t block_fill;   // Number of bytes in block buffer
+	uint8_t *memory;       // Output buffer (memory sink)
+	uint32_t capacity;     // Size of output buffer (memory sink)
+	struct Shm_ring_s *shm; // Shared memory ring (shared memory sink)
+	struct Adpcm_encoder_s *adpcm; // Encoder (ADPCM sink)
+	uint64_t length;       // Number of bytes written (encoded bytes for ADPCM sink)
+	Sink_format_t format;
+	uint8_t error;         // Set on I/O error
+} Sink_t;
+
+/**
+ * Output sink of computer port
+ */
+extern Sink_t output_sink;
+
+/**
+ * Open a sink
+ *
+ * @param sink Pointer to a Sink_t object
+ * @param type Sink type
+ * @param filename Output file name (raw, WAV and ADPCM sinks) or shared memory object name (shared memory sink)
+ * @param format Sample format (ADPCM sink : mono, 8 or 16 bits input samples)
+ * @return 1 on success, 0 on error
+ */
+uint8_t sink_open(Sink_t *sink, uint8_t type, const char *filename, const Sink_format_t *format);
+
+/**
+ * Write a block of bytes to a sink (bypass block buffer)
+ *
+ * @param sink Pointer to a Sink_t object
+ * @param data Pointer to data to write
+ * @param length Number of bytes to write
+ * @return 1 on success, 0 on error
+ */
+uint8_t sink_write(Sink_t *sink, const void *data, uint32_t length);
+
+/**
+ * Flush block buffer of a sink
+ *
+ * @param sink Pointer to a Sink_t object
+ * @return 1 on success, 0 on error
+ */
+uint8_t sink_flush(Sink_t *sink);
+
+/**
+ * Flush and close a sink (patch header of WAV sink)
+ *
+ * @param sink Pointer to a Sink_t object
+ * @remarks Memory buffer of memory sink is not freed, use sink_free_memory()
+ */
+void sink_close(Sink_t *sink);
+
+/**
+ * Free memory buffer of a closed memory sink
+ *
+ * @param sink Pointer to a Sink_t object
+ */
+void sink_free_memory(Sink_t *sink);
+
+/**
+ * Put a single byte into sink block buffer
+ *
+ * @param sink Pointer to a Sink_t object
+ * @param value Byte to write
+ */
+static inline void sink_put(Sink_t *sink, uint8_t value) {
+	sink->block[sink->block_fill++] = value;
+	if (sink->block_fill == SINK_BLOCK_SIZE)
+		sink_flush(sink);
+}
+
+#endif // _SINK_H_
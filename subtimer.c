@@ -67,3 +67,27 @@ uint8_t subtimer_tick_increment(volatile SubTimer_t *timer, uint16_t increment)
 		return 0;
 	}
 }
+
+uint8_t subtimer_tick_batch(volatile SubTimer_t *timer, uint16_t increment, uint8_t *ticks) {
+
+	/* Ticks without event before the compare match */
+	uint32_t remaining = 0;
+	if (timer->tick_counter < timer->tick_compare)
+		remaining = (timer->tick_compare - timer->tick_counter + increment - 1) / increment;
+
+	/* No compare match : count every tick */
+	if (remaining >= *ticks) {
+		timer->tick_counter += (uint32_t)*ticks * increment;
+		*ticks = 0;
+		
+		/* Notice parent function of no event */
+		return 0;
+	}
+
+	/* Reset SubTimer */
+	*ticks -= remaining + 1;
+	timer->tick_counter = 0;
+
+	/* Notice parent function of event */
+	return 1;
+}
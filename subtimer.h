@@ -99,6 +99,17 @@ uint8_t subtimer_tick(volatile SubTimer_t *timer);
  */
 uint8_t subtimer_tick_increment(volatile SubTimer_t *timer, uint16_t increment);
 
+/**
+ * Process several tick events of a SubTimer object at once, until the first compare match
+ *
+ * @param timer Pointer to a SubTimer_t object
+ * @param increment Increment value (user specified)
+ * @param ticks Pointer to the number of ticks to process, decreased by the number of processed ticks
+ * @return 0 if no event (no compare match), 1 if event (compare match)
+ * @remarks Same counter and events as one subtimer_tick_increment() call per tick
+ */
+uint8_t subtimer_tick_batch(volatile SubTimer_t *timer, uint16_t increment, uint8_t *ticks);
+
 #endif // _SUBTIMER_H_
 
 
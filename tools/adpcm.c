@@ -0,0 +1,217 @@
+/**
+ * @file adpcm.c
+ * @brief Generic digital chiptune generator - IMA-ADPCM encoder check and decoder
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool check the IMA-ADPCM encoder (see adpcm.h) or decode a file written by the ADPCM sink :
+ * - adpcm [raw file] : encode a raw 8 bits render (samples/output_adsr.raw by default) RUN_COUNT times,
+ *   decode it and print one JSON object : input and encoded bytes, encode speed (median ns per sample, real-time factor)
+ *   and signal to noise ratio of the decoded samples against the input samples.
+ * - adpcm -d input.wav output.raw : decode an IMA-ADPCM WAV file (ADPCM sink) to raw 16 bits signed samples (little-endian).
+ *
+ * Return 0 on success, 1 on error.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Build with the linux port (see README.md)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>          // For hardcoded type
+#include <stdio.h>           // For printf
+#include <stdlib.h>          // For malloc
+#include <string.h>          // For memcmp
+#include <math.h>            // For log10
+#include <time.h>            // For clock_gettime
+#include "../common.h"       // For common macro
+#include "../port.h"         // For platform dependent macro
+#include "../adpcm.h"        // For IMA-ADPCM encoder
+
+/* Nanoseconds per second */
+#define NS_PER_SECOND 1000000000ULL
+
+/* Maximum length of an input file */
+#define MAX_INPUT_LENGTH (16UL * 1024 * 1024)
+
+/* Number of encodes */
+#define RUN_COUNT 11
+
+/* Number of samples per adpcm_encode_u8() call (like a render block) */
+#define BLOCK_SIZE 4096
+
+/* Get monotonic time in nanoseconds */
+static inline uint64_t get_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+/* Compare two uint64_t (for qsort) */
+static int compare_uint64(const void *a, const void *b) {
+	uint64_t value_a = *(const uint64_t *)a, value_b = *(const uint64_t *)b;
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+/* Read a little-endian 16 / 32 bits value */
+static inline uint16_t get_le16(const uint8_t *buffer) {
+	return buffer[0] | (buffer[1] << 8);
+}
+
+static inline uint32_t get_le32(const uint8_t *buffer) {
+	return get_le16(buffer) | ((uint32_t)get_le16(buffer + 2) << 16);
+}
+
+/* Load a whole file, return its length (0 on error) */
+static uint32_t load_file(const char *filename, uint8_t *buffer) {
+	FILE *file = fopen(filename, "rb");
+	if (!file) {
+		perror(filename);
+		return 0;
+	}
+	uint32_t length = fread(buffer, 1, MAX_INPUT_LENGTH, file);
+	fclose(file);
+	return length;
+}
+
+/* Encode a whole input by blocks, return number of encoded bytes */
+static uint32_t encode(const uint8_t *input, uint32_t length, uint8_t *output) {
+	Adpcm_encoder_t encoder;
+	uint32_t bytes = 0;
+
+	adpcm_encoder_init(&encoder);
+	for (uint32_t first = 0; first < length; first += BLOCK_SIZE) {
+		uint32_t count = (length - first < BLOCK_SIZE) ? length - first : BLOCK_SIZE;
+		bytes += adpcm_encode_u8(&encoder, input + first, count, output + bytes);
+	}
+	return bytes + adpcm_flush(&encoder, output + bytes);
+}
+
+/* Encode a raw 8 bits file, print speed and precision */
+static uint8_t check_encoder(const char *filename) {
+	static uint64_t ns[RUN_COUNT];
+	uint8_t *input = malloc(MAX_INPUT_LENGTH);
+	uint8_t *output = malloc(MAX_INPUT_LENGTH);
+	int16_t *samples = malloc(ADPCM_SAMPLES_PER_BLOCK * sizeof(int16_t));
+	if (!input || !output || !samples) {
+		fprintf(stderr, "Out of memory\n");
+		return 0;
+	}
+	uint32_t length = load_file(filename, input);
+	if (length == 0)
+		return 0;
+
+	/* Encode */
+	uint32_t bytes = 0;
+	for (uint8_t run = 0; run < RUN_COUNT; ++run) {
+		uint64_t start_ns = get_time_ns();
+		bytes = encode(input, length, output);
+		ns[run] = get_time_ns() - start_ns;
+	}
+	qsort(ns, RUN_COUNT, sizeof(uint64_t), compare_uint64);
+	double ns_per_sample = (double)ns[RUN_COUNT / 2] / length;
+
+	/* Decode, compare with input */
+	double signal = 0, noise = 0;
+	uint32_t max_error = 0;
+	for (uint32_t block = 0; block < bytes / ADPCM_BLOCK_ALIGN; ++block) {
+		adpcm_decode_block(output + block * ADPCM_BLOCK_ALIGN, samples);
+		for (uint16_t i = 0; i < ADPCM_SAMPLES_PER_BLOCK; ++i) {
+			uint32_t position = block * ADPCM_SAMPLES_PER_BLOCK + i;
+			if (position >= length)
+				break;
+			int32_t reference = (int16_t)((input[position] ^ 0x80) << 8);
+			int32_t error = samples[i] - reference;
+			signal += (double)reference * reference;
+			noise += (double)error * error;
+			if ((uint32_t)abs(error) > max_error)
+				max_error = abs(error);
+		}
+	}
+
+	printf("{\"input_bytes\": %u, \"encoded_bytes\": %u, \"ratio\": %.3f, \"ns_per_sample\": %.3f, \"realtime_factor\": %.0f, "
+			"\"snr_db\": %.2f, \"max_error\": %u}\n", length, bytes, (double)bytes / length, ns_per_sample,
+			(double)NS_PER_SECOND / SAMPLE_RATE / ns_per_sample, 10 * log10(signal / (noise ? noise : 1)), max_error);
+	free(input);
+	free(output);
+	free(samples);
+	return 1;
+}
+
+/* Decode an IMA-ADPCM WAV file to raw 16 bits samples */
+static uint8_t decode_file(const char *input_filename, const char *output_filename) {
+	uint8_t *input = malloc(MAX_INPUT_LENGTH);
+	int16_t samples[ADPCM_SAMPLES_PER_BLOCK];
+	if (!input) {
+		fprintf(stderr, "Out of memory\n");
+		return 0;
+	}
+	uint32_t length = load_file(input_filename, input);
+
+	/* Check header (as written by the ADPCM sink) */
+	if (length < 60 || memcmp(input, "RIFF", 4) || memcmp(input + 8, "WAVEfmt ", 8) || get_le16(input + 20) != 0x11
+			|| get_le16(input + 22) != 1 || get_le16(input + 32) != ADPCM_BLOCK_ALIGN
+			|| get_le16(input + 38) != ADPCM_SAMPLES_PER_BLOCK || memcmp(input + 52, "data", 4)) {
+		fprintf(stderr, "%s : not a mono IMA-ADPCM WAV file with %u bytes blocks\n", input_filename, ADPCM_BLOCK_ALIGN);
+		free(input);
+		return 0;
+	}
+	uint32_t count = get_le32(input + 48);
+	uint32_t data_length = get_le32(input + 56);
+	if (data_length > length - 60)
+		data_length = length - 60;
+
+	FILE *output = fopen(output_filename, "wb");
+	if (!output) {
+		perror(output_filename);
+		free(input);
+		return 0;
+	}
+
+	/* Decode block per block, drop the padding of the last block */
+	uint32_t written = 0;
+	for (uint32_t block = 0; block < data_length / ADPCM_BLOCK_ALIGN && written < count; ++block) {
+		adpcm_decode_block(input + 60 + block * ADPCM_BLOCK_ALIGN, samples);
+		uint32_t block_count = (count - written < ADPCM_SAMPLES_PER_BLOCK) ? count - written : ADPCM_SAMPLES_PER_BLOCK;
+		for (uint32_t i = 0; i < block_count; ++i) {
+			uint8_t bytes[2] = { low(samples[i]), high(samples[i]) };
+			fwrite(bytes, 1, 2, output);
+		}
+		written += block_count;
+	}
+	fclose(output);
+	free(input);
+
+	printf("%s : %u samples decoded\n", output_filename, written);
+	return written == count;
+}
+
+/* Program entry point */
+int main(int argc, char **argv) {
+	if (argc > 1 && !strcmp(argv[1], "-d")) {
+		if (argc < 4) {
+			fprintf(stderr, "Usage : adpcm -d input.wav output.raw\n");
+			return 1;
+		}
+		return decode_file(argv[2], argv[3]) ? 0 : 1;
+	}
+	return check_encoder((argc > 1) ? argv[1] : "samples/output_adsr.raw") ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+/**
+ * @file bench_float.c
+ * @brief Generic digital chiptune generator - Float32 engine versus fixed-point engine benchmark
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool compare the float32 engine (see float_engine.h) with the fixed-point engine and print one JSON object per result on stdout :
+ * - speed : render of the bundled tracker file, median and minimum ns per sample of RUN_COUNT renders
+ * - sinus_snr : signal to noise and distortion ratio of one sinus channel (no ADSR) at some channel volumes,
+ *   the ideal sinus (same frequency) is fitted to the output, everything else is noise
+ * - correlation : correlation of the float engine render of the bundled tracker file with the fixed-point one (same song, same timing)
+ *
+ * Engines : "fixed u8" (mixer_render_sample(), 8 bits output), "fixed f32" (mixer_render_sample_f32(), wide output path)
+ * and "float" (float_engine_render()).\n
+ * Usage : bench_float\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Build with the linux port and FLOAT_ENGINE defined (see README.md)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>            // For hardcoded type
+#include <stdio.h>             // For printf
+#include <stdlib.h>            // For malloc
+#include <math.h>              // For sin
+#include <time.h>              // For clock_gettime
+#include "../common.h"         // For common macro
+#include "../port.h"           // For platform dependent macro
+#include "../tracker.h"        // For tracker commands
+#include "../tracker_data.h"   // For english note notation
+#include "../subtimer.h"       // For SubTimer structure
+#include "../envelope.h"       // For ADSR envelope name
+#include "../oscillator.h"     // For Waveform name
+#include "../mixer.h"          // For channel name
+#include "../modulation.h"     // For modulators
+#include "../voice.h"          // For voice pool
+#include "../render.h"         // For render session
+#include "../float_engine.h"   // For float engine
+
+#ifndef FLOAT_ENGINE
+#error "bench_float need FLOAT_ENGINE (build with -DFLOAT_ENGINE)"
+#endif
+#if OUTPUT_CHANNELS > 1
+#error "bench_float compare mono renders (build with OUTPUT_CHANNELS = 1)"
+#endif
+
+/* Nanoseconds per second */
+#define NS_PER_SECOND 1000000000ULL
+
+/* Maximum length of a render (longer than the bundled tracker file) */
+#define MAX_RENDER_LENGTH (4UL * 1024 * 1024)
+
+/* Number of samples per render_samples() / float_engine_render() call */
+#define BLOCK_SIZE 4096
+
+/* Number of renders per engine */
+#define RUN_COUNT 11
+
+/* Tunning word and length (whole number of periods) of the sinus test */
+#define SINUS_TUNNING_WORD 37
+#define SINUS_LENGTH (256UL * 64)
+
+/* Tempo timer (see tracker.c) */
+extern volatile SubTimer_t tempo_timer;
+
+/* Render buffers (-1.0 to 1.0) */
+static float *fixed_samples;
+static float *float_samples;
+static uint8_t block[BLOCK_SIZE];
+
+/* Engine */
+typedef struct {
+	const char *name;
+	uint32_t (*render_song)(float *buffer);             // Render the bundled tracker file, return length
+	void (*render_sinus)(float *buffer, uint32_t length); // Render the sinus test (engine set up)
+} Engine_t;
+
+/* Get monotonic time in nanoseconds */
+static inline uint64_t get_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+/* Compare two uint64_t (for qsort) */
+static int compare_uint64(const void *a, const void *b) {
+	uint64_t value_a = *(const uint64_t *)a, value_b = *(const uint64_t *)b;
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+/* ---------- Fixed-point engine, 8 bits output ---------- */
+
+static uint32_t fixed_u8_song(float *buffer) {
+	const Render_limits_t limits = { MAX_RENDER_LENGTH, 0 };
+	Render_session_t session;
+	uint32_t length = 0;
+
+	render_start(&session, &limits);
+	while (session.status == RENDER_OK) {
+		uint32_t count = render_samples(&session, block, BLOCK_SIZE);
+		for (uint32_t i = 0; i < count; ++i)
+			buffer[length + i] = (block[i] - 127.5f) / 127.5f;
+		length += count;
+	}
+	return length;
+}
+
+static void fixed_u8_sinus(float *buffer, uint32_t length) {
+	for (uint32_t i = 0; i < length; ++i)
+		buffer[i] = (mixer_render_sample() - 127.5f) / 127.5f;
+}
+
+/* ---------- Fixed-point engine, wide output path ---------- */
+
+static uint32_t fixed_f32_song(float *buffer) {
+	uint32_t length = 0;
+
+	engine_reset();
+	tracker_fetch_execute(); // Same startup sequence as main()
+	while (length < MAX_RENDER_LENGTH) {
+		float sample = mixer_render_sample_f32();
+		if (tracker_end_of_stream)
+			break;
+		buffer[length++] = sample;
+	}
+	return length;
+}
+
+static void fixed_f32_sinus(float *buffer, uint32_t length) {
+	for (uint32_t i = 0; i < length; ++i)
+		buffer[i] = mixer_render_sample_f32();
+}
+
+/* ---------- Float engine ---------- */
+
+static uint32_t float_song(float *buffer) {
+	const Render_limits_t limits = { MAX_RENDER_LENGTH, 0 };
+	Render_session_t session;
+	uint32_t length = 0;
+
+	render_start(&session, &limits);
+	float_engine_reset();
+	while (session.status == RENDER_OK)
+		length += float_engine_render(&session, buffer + length, BLOCK_SIZE);
+	return length;
+}
+
+static void float_sinus(float *buffer, uint32_t length) {
+	const Render_limits_t limits = { 0, 0 };
+	Render_session_t session = { limits, 0, RENDER_OK };
+
+	float_engine_reset();
+	float_engine_render(&session, buffer, length);
+}
+
+/* Engines */
+static const Engine_t engines[] = {
+	{ "fixed u8", fixed_u8_song, fixed_u8_sinus },
+	{ "fixed f32", fixed_f32_song, fixed_f32_sinus },
+	{ "float", float_song, float_sinus }
+};
+
+/* ---------- Tests ---------- */
+
+/* Render the bundled tracker file RUN_COUNT times, print speed */
+static uint32_t measure_speed(const Engine_t *engine, float *buffer) {
+	static uint64_t ns[RUN_COUNT];
+	uint32_t length = 0;
+
+	for (uint8_t run = 0; run < RUN_COUNT; ++run) {
+		uint64_t start_ns = get_time_ns();
+		length = engine->render_song(buffer);
+		ns[run] = get_time_ns() - start_ns;
+	}
+	qsort(ns, RUN_COUNT, sizeof(uint64_t), compare_uint64);
+
+	printf("{\"test\": \"speed\", \"engine\": \"%s\", \"samples\": %lu, \"ns_per_sample\": %.3f, \"ns_per_sample_min\": %.3f}\n",
+			engine->name, (unsigned long)length, (double)ns[RUN_COUNT / 2] / length, (double)ns[0] / length);
+	fflush(stdout);
+	return length;
+}
+
+/* Render one sinus channel at volume, print signal to noise and distortion ratio */
+static void measure_sinus_snr(const Engine_t *engine, uint8_t volume) {
+	engine_reset();
+	subtimer_set_compare(&tempo_timer, 0xFFFFFFFF); // No tempo tick
+	mixer_set_global_volume(255);
+	mixer_set_wave(CHANNEL_1, WF_SINUS);
+	mixer_set_volume(CHANNEL_1, volume);
+	mixer_note_on(CHANNEL_1, SINUS_TUNNING_WORD);
+	engine->render_sinus(float_samples, SINUS_LENGTH);
+
+	/* Fit sinus (whole number of periods : sin, cos and DC are orthogonal) */
+	double sin_sum = 0, cos_sum = 0, dc = 0;
+	for (uint32_t i = 0; i < SINUS_LENGTH; ++i) {
+		double angle = 2 * M_PI * SINUS_TUNNING_WORD * i / 256;
+		sin_sum += float_samples[i] * sin(angle);
+		cos_sum += float_samples[i] * cos(angle);
+		dc += float_samples[i];
+	}
+	double a = 2 * sin_sum / SINUS_LENGTH, b = 2 * cos_sum / SINUS_LENGTH;
+	dc /= SINUS_LENGTH;
+
+	/* Noise and distortion */
+	double noise = 0;
+	for (uint32_t i = 0; i < SINUS_LENGTH; ++i) {
+		double angle = 2 * M_PI * SINUS_TUNNING_WORD * i / 256;
+		double error = float_samples[i] - (a * sin(angle) + b * cos(angle) + dc);
+		noise += error * error;
+	}
+	noise /= SINUS_LENGTH;
+
+	printf("{\"test\": \"sinus_snr\", \"engine\": \"%s\", \"volume\": %u, \"amplitude\": %.6f, \"snr_db\": %.2f}\n",
+			engine->name, volume, sqrt(a * a + b * b), 10 * log10((a * a + b * b) / 2 / noise));
+	fflush(stdout);
+}
+
+/* Print correlation of two renders */
+static void print_correlation(const char *name, const float *samples_1, const float *samples_2, uint32_t length) {
+	double sum_1 = 0, sum_2 = 0, sum_11 = 0, sum_22 = 0, sum_12 = 0;
+	for (uint32_t i = 0; i < length; ++i) {
+		sum_1 += samples_1[i];
+		sum_2 += samples_2[i];
+		sum_11 += (double)samples_1[i] * samples_1[i];
+		sum_22 += (double)samples_2[i] * samples_2[i];
+		sum_12 += (double)samples_1[i] * samples_2[i];
+	}
+	double covariance = sum_12 - sum_1 * sum_2 / length;
+	double variance_1 = sum_11 - sum_1 * sum_1 / length, variance_2 = sum_22 - sum_2 * sum_2 / length;
+	printf("{\"test\": \"correlation\", \"engines\": \"%s\", \"samples\": %lu, \"correlation\": %.4f}\n",
+			name, (unsigned long)length, covariance / sqrt(variance_1 * variance_2));
+	fflush(stdout);
+}
+
+int main(void) {
+	fixed_samples = malloc(MAX_RENDER_LENGTH * sizeof(float));
+	float_samples = malloc(MAX_RENDER_LENGTH * sizeof(float));
+	if (fixed_samples == NULL || float_samples == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	/* Speed (the last renders of "fixed f32" and "float" are kept for the correlation) */
+	measure_speed(&engines[0], float_samples);
+	uint32_t fixed_length = measure_speed(&engines[1], fixed_samples);
+	uint32_t float_length = measure_speed(&engines[2], float_samples);
+
+	/* Same song */
+	if (fixed_length != float_length)
+		fprintf(stderr, "Length mismatch : fixed f32 %lu, float %lu samples\n", (unsigned long)fixed_length, (unsigned long)float_length);
+	print_correlation("fixed f32 / float", fixed_samples, float_samples, (fixed_length < float_length) ? fixed_length : float_length);
+
+	/* Precision */
+	const uint8_t volumes[] = { 255, 64, 16 };
+	for (uint8_t engine = 0; engine < sizeof(engines) / sizeof(engines[0]); ++engine)
+		for (uint8_t i = 0; i < sizeof(volumes); ++i)
+			measure_sinus_snr(&engines[engine], volumes[i]);
+
+	free(fixed_samples);
+	free(float_samples);
+	return (fixed_length == float_length) ? 0 : 1;
+}
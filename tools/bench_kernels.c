@@ -0,0 +1,592 @@
+/**
+ * @file bench_kernels.c
+ * @brief Generic digital chiptune generator - Kernel microbenchmarks
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool time each kernel of the engine in isolation and print one JSON object per kernel on stdout :
+ * - get_waveform_sample() for each waveform, prepare_next_sample()
+ * - get_envelope_sample() in each ADSR state
+ * - scale_value() with and without SCALE_WITH_AUTO_OFFSET (see bench_scale.c), map_sample()
+ * - gain stages (high byte of value x scale) : multiply, software multiply, SCALE_SHIFT_ADD, SCALE_GAIN_TABLE,
+ *   with their error against the exact product over every value and scale pair
+ * - tracker_fetch_execute() for each opcode (and SET_INSTRUMENT with INSTRUMENT_BANK)
+ * - mixer_render_sample() 8 bits path, and wide paths (16 bits, float, see mixer.h), without tempo tick
+ * - with MODULATION : modulation_update() with every modulator of every channel on, and mixer_render_sample() 8 bits path with them
+ *
+ * Inputs are spread over 256 objects (oscillators, envelopes, ...) with realistic values (note range, volumes, mixer range).\n
+ * Each kernel is run by batches of BATCH_SIZE operations, the median and minimum of BATCH_COUNT batches are reported,
+ * in ns per operation and in TSC cycles per operation (x86 only, the TSC count at a constant reference frequency).\n
+ * The "loop" kernel is the cost of the benchmark loop alone.\n
+ * The "software multiply" gain stage is a 16 x 16 bits shift-add multiply like the libgcc one used on MCU without hardware
+ * multiplier (ATtiny), it is the reference of the other gain stages for such MCU (the host multiply is nearly free).\n
+ * Usage : bench_kernels\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Build with the linux port and RENDER_API defined (see README.md), tracker_fetch_execute() timings include the RENDER_API read trace
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>          // For hardcoded type
+#include <stdio.h>           // For printf
+#include <stdlib.h>          // For qsort
+#include <time.h>            // For clock_gettime
+#include "../common.h"       // For common macro
+
+/* scale_value() is inline and configured at compile time, build this file with SCALE_WITH_AUTO_OFFSET */
+#ifndef SCALE_WITH_AUTO_OFFSET
+#define SCALE_WITH_AUTO_OFFSET
+#endif
+
+#include "../port.h"         // For platform dependent macro
+#include "../tracker.h"      // For tracker commands
+#include "../tracker_data.h" // For english note notation
+#include "../subtimer.h"     // For SubTimer structure
+#include "../envelope.h"     // For ADSR envelope name
+#include "../oscillator.h"   // For Waveform name
+#include "../mixer.h"        // For channel name
+#include "../modulation.h"   // For modulators
+#include "../voice.h"        // For voice pool
+#include "../render.h"       // For engine reset
+#include "song_writer.h"     // For opcodes streams
+
+#ifndef RENDER_API
+#error "bench_kernels need RENDER_API (build with -DRENDER_API)"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>       // For __rdtsc
+#define HAVE_TSC
+#endif
+
+/* Nanoseconds per second */
+#define NS_PER_SECOND 1000000000ULL
+
+/* Number of operations per batch */
+#define BATCH_SIZE 4096
+
+/* Number of batches per kernel */
+#define BATCH_COUNT 101
+
+/* Number of input objects (oscillators, envelopes, values) */
+#define INPUT_COUNT 256
+
+/* Scale count values (truncate mode, see bench_scale.c) */
+uint32_t bench_scale_truncate(const uint16_t *values, const uint16_t *scales, uint32_t count);
+
+/* Inputs */
+static volatile Oscillator_t oscillators[INPUT_COUNT];
+static volatile Envelope_t envelopes[INPUT_COUNT];
+static uint16_t values[BATCH_SIZE];
+static uint16_t scales[BATCH_SIZE];
+static int16_t mix_values[BATCH_SIZE];
+
+/* Opcode stream of the tracker_fetch_execute() kernel */
+static Song_writer_t song;
+
+/* Parameter of the current kernel (waveform, ADSR state) */
+static uint8_t parameter;
+
+/* Results of the current kernel are accumulated here (avoid dead code elimination) */
+static volatile uint32_t result;
+
+/* Random numbers for inputs (xorshift) */
+static uint32_t random_state = 0x12345678;
+static inline uint32_t next_random(void) {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+/* Get monotonic time in nanoseconds */
+static inline uint64_t get_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+/* Get TSC cycles count */
+static inline uint64_t get_cycles(void) {
+#ifdef HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/* Compare two uint64_t (for qsort) */
+static int compare_uint64(const void *a, const void *b) {
+	uint64_t value_a = *(const uint64_t *)a, value_b = *(const uint64_t *)b;
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+/* Run a kernel (prepare is called before each batch and is not timed), print result */
+static void measure(const char *kernel, const char *variant, void (*prepare)(void), void (*run)(void)) {
+	static uint64_t ns[BATCH_COUNT], cycles[BATCH_COUNT];
+
+	for (uint16_t batch = 0; batch < BATCH_COUNT; ++batch) {
+		if (prepare)
+			prepare();
+		uint64_t start_ns = get_time_ns();
+		uint64_t start_cycles = get_cycles();
+		run();
+		cycles[batch] = get_cycles() - start_cycles;
+		ns[batch] = get_time_ns() - start_ns;
+	}
+	qsort(ns, BATCH_COUNT, sizeof(uint64_t), compare_uint64);
+	qsort(cycles, BATCH_COUNT, sizeof(uint64_t), compare_uint64);
+
+	printf("{\"kernel\": \"%s\", \"variant\": \"%s\", \"ops\": %u, \"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f",
+			kernel, variant, BATCH_SIZE, (double)ns[BATCH_COUNT / 2] / BATCH_SIZE, (double)ns[0] / BATCH_SIZE);
+#ifdef HAVE_TSC
+	printf(", \"cycles_per_op\": %.2f, \"cycles_per_op_min\": %.2f}\n",
+			(double)cycles[BATCH_COUNT / 2] / BATCH_SIZE, (double)cycles[0] / BATCH_SIZE);
+#else
+	printf(", \"cycles_per_op\": null, \"cycles_per_op_min\": null}\n");
+#endif
+}
+
+/* ---------- Loop overhead ---------- */
+
+static void run_loop(void) {
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		result += i;
+}
+
+/* ---------- Oscillator ---------- */
+
+/* Oscillators with tunning words of notes C3 to C7 (@8KHz) and random phases */
+static void prepare_oscillators(void) {
+	for (uint16_t i = 0; i < INPUT_COUNT; ++i) {
+		set_oscillator_waveform(oscillators + i, parameter);
+		set_oscillator_duty(oscillators + i, 127);
+		set_oscillator_tunning_word(oscillators + i, 2 + next_random() % 60);
+		oscillators[i].phase_accumulator = next_random();
+	}
+}
+
+static void run_waveform_sample(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += get_waveform_sample(oscillators + (i % INPUT_COUNT));
+	result += sum;
+}
+
+static void run_prepare_next_sample(void) {
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		prepare_next_sample(oscillators + (i % INPUT_COUNT));
+}
+
+/* ---------- Envelope ---------- */
+
+/* Envelope states of the get_envelope_sample() kernel (ended envelopes use ENV_RELEASE) */
+#define ENVELOPE_NONE 0xFE
+#define ENVELOPE_ENDED 0xFF
+
+/* Envelopes in state parameter, slow enough to stay in this state during a batch */
+static void prepare_envelopes(void) {
+	setup_adsr_envelope(ADSR_USER_1, 1000, 1000, 127, 1000);
+	for (uint16_t i = 0; i < INPUT_COUNT; ++i) {
+		volatile Envelope_t *envelope = envelopes + i;
+		envelope->type = (parameter == ENVELOPE_NONE) ? ADSR_NONE : ADSR_USER_1;
+		envelope->ended = 0;
+		envelope->value = 0;
+		envelope->value_change_timer.tick_counter = next_random() % 1024;
+		if (parameter == ENVELOPE_ENDED) {
+			reset_envelope(envelope, ENV_RELEASE);
+			envelope->ended = 1;
+		} else if (parameter != ENVELOPE_NONE) {
+			reset_envelope(envelope, parameter);
+		}
+	}
+}
+
+static void run_envelope_sample(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += get_envelope_sample(envelopes + (i % INPUT_COUNT));
+	result += sum;
+}
+
+/* ---------- Gain and mapping ---------- */
+
+/* Waveform values (uniform) scaled by envelope / volume values (1/4 at full scale) */
+static void prepare_scale_values(void) {
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i) {
+		values[i] = next_random() & 0xFF;
+		scales[i] = (next_random() & 3) ? next_random() & 0xFF : 255;
+	}
+}
+
+static void run_scale_auto_offset(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += scale_value(values[i], scales[i]);
+	result += sum;
+}
+
+static void run_scale_truncate(void) {
+	result += bench_scale_truncate(values, scales, BATCH_SIZE);
+}
+
+/* 16 x 16 bits multiply without hardware multiplier (like libgcc on ATtiny), high byte of the product */
+static inline uint8_t software_multiply(uint16_t value, uint16_t scale) {
+	uint16_t product = 0;
+	for (; scale; scale >>= 1, value <<= 1)
+		if (scale & 1)
+			product += value;
+	return product >> 8;
+}
+
+static void run_gain_multiply(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += (values[i] * scales[i]) >> 8;
+	result += sum;
+}
+
+static void run_gain_software_multiply(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += software_multiply(values[i], scales[i]);
+	result += sum;
+}
+
+static void run_gain_shift_add(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += scale_shift_add(values[i], scales[i]);
+	result += sum;
+}
+
+static void run_gain_table(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += scale_gain_table(values[i], scales[i]);
+	result += sum;
+}
+
+/* Error of a gain stage against the exact product, over every value and scale pair, print result */
+static void gain_error(const char *variant, uint8_t (*gain)(uint8_t value, uint8_t scale)) {
+	uint32_t max_error = 0;
+	uint64_t error_sum = 0;
+	for (uint16_t value = 0; value < 256; ++value) {
+		for (uint16_t scale = 0; scale < 256; ++scale) {
+			int32_t error = (int32_t)gain(value, scale) - (int32_t)((value * scale) >> 8);
+			uint32_t magnitude = (error < 0) ? -error : error;
+			error_sum += magnitude;
+			if (magnitude > max_error)
+				max_error = magnitude;
+		}
+	}
+	printf("{\"kernel\": \"gain_error\", \"variant\": \"%s\", \"max_error\": %lu, \"mean_error\": %.3f}\n",
+			variant, (unsigned long)max_error, (double)error_sum / (256 * 256));
+	fflush(stdout);
+}
+
+static uint8_t gain_software_multiply(uint8_t value, uint8_t scale) {
+	return software_multiply(value, scale);
+}
+
+static uint8_t gain_shift_add(uint8_t value, uint8_t scale) {
+	return scale_shift_add(value, scale);
+}
+
+static uint8_t gain_lookup(uint8_t value, uint8_t scale) {
+	return scale_gain_table(value, scale);
+}
+
+/* Sums of NUMBERS_OF_CHANNEL channels without DC offset */
+static void prepare_mix_values(void) {
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		mix_values[i] = (int16_t)(next_random() % (NUMBERS_OF_CHANNEL * 254 + 1)) - NUMBERS_OF_CHANNEL * 127;
+}
+
+static void run_map_sample(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += map_sample(mix_values[i], NUMBERS_OF_CHANNEL * -127, NUMBERS_OF_CHANNEL * 127, 0, 255);
+	result += sum;
+}
+
+/* ---------- Tracker ---------- */
+
+/* Write BATCH_SIZE instructions of opcode parameter (channels in turn) */
+static void write_opcode_stream(void) {
+	song.length = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i) {
+		uint8_t channel = i % NUMBERS_OF_CHANNEL;
+		uint16_t address = song.length;
+		switch (parameter) {
+		case SET_TEMPO:
+			song_put_byte(&song, SET_TEMPO);
+			song_put_word(&song, 60 + next_random() % 600);
+			break;
+
+		case SET_WAVE:
+			song_put_byte(&song, SET_WAVE | channel);
+			song_put_byte(&song, WF_SINUS + next_random() % 5);
+			break;
+
+		case SET_VOLUME:
+		case SET_GLOBAL_VOLUME:
+		case SET_DUTY:
+			song_put_byte(&song, parameter | channel);
+			song_put_byte(&song, next_random());
+			break;
+
+		case NOTE_ON:
+			song_put_byte(&song, NOTE_ON | channel);
+			song_put_byte(&song, NOTE_C3 + next_random() % 48);
+			break;
+
+		case SYNC_OSCILLATOR:
+			song_put_byte(&song, SYNC_OSCILLATOR | channel);
+			song_put_byte(&song, (channel + 1) % NUMBERS_OF_CHANNEL);
+			break;
+
+		case SET_ADSR:
+			song_put_byte(&song, SET_ADSR | channel);
+			song_put_byte(&song, ADSR_USER_1);
+			break;
+
+		case JUMP_IN_FILE: // Jump to next instruction
+			song_put_byte(&song, JUMP_IN_FILE);
+			song_put_word(&song, address + 3);
+			break;
+
+		case DIRECT_EXEC: // Execute 4 NO_ACTION in one step
+			song_put_byte(&song, DIRECT_EXEC);
+			song_put_byte(&song, 4);
+			for (uint8_t j = 0; j < 4; ++j)
+				song_put_byte(&song, NO_ACTION);
+			break;
+
+#ifdef INSTRUMENT_BANK
+		case SET_INSTRUMENT:
+			song_put_byte(&song, SET_INSTRUMENT);
+			song_put_byte(&song, channel);
+			song_put_byte(&song, next_random() % INSTRUMENTS);
+			break;
+#endif
+
+		case SET_ADSR_VALUES:
+			song_put_adsr_values(&song, ADSR_USER_1, 1 + next_random() % 500, 1 + next_random() % 500, next_random(), 1 + next_random() % 500);
+			break;
+
+		default: // Opcodes without argument
+			song_put_byte(&song, parameter | channel);
+			break;
+		}
+	}
+	tracker_load_song(song.opcodes, song.length);
+}
+
+/* Restart the opcode stream with playing channels */
+static void prepare_tracker(void) {
+	mixer_set_global_volume(255);
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		mixer_set_wave(channel, WF_SINUS);
+		mixer_set_volume(channel, 255);
+		mixer_set_adsr(channel, ADSR_USER_1);
+	}
+#ifdef INSTRUMENT_BANK
+	for (uint8_t instrument = 0; instrument < INSTRUMENTS; ++instrument)
+		setup_instrument(instrument, WF_SINUS + instrument % 5, 127, 255, ADSR_USER_1);
+#endif
+	tracker_index = 0;
+}
+
+static void run_tracker(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += tracker_fetch_execute();
+	result += sum;
+}
+
+/* ---------- Output paths ---------- */
+
+/* Tempo timer (see tracker.c) */
+extern volatile SubTimer_t tempo_timer;
+
+/* Playing channels (all waveforms, random volumes), tempo tick disabled */
+static void prepare_render(void) {
+	engine_reset();
+	subtimer_set_compare(&tempo_timer, 0xFFFFFFFF);
+	mixer_set_global_volume(255);
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		mixer_set_wave(channel, WF_SINUS + channel % 5);
+		mixer_set_volume(channel, next_random());
+		mixer_set_adsr(channel, ADSR_NONE);
+		mixer_note_on(channel, 32 + next_random() % 96);
+	}
+}
+
+static void run_render_u8(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += mixer_render_sample();
+	result += sum;
+}
+
+static void run_render_s16(void) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += mixer_render_sample_s16();
+	result += sum;
+}
+
+static void run_render_f32(void) {
+	float sum = 0;
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		sum += mixer_render_sample_f32();
+	result += sum;
+}
+
+#ifdef MODULATION
+/* Playing channels with every modulator on (vibrato, arpeggio, portamento, PWM, volume slide) */
+static void prepare_modulation(void) {
+	prepare_render();
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		modulation_set_vibrato(channel, 32, 5);
+		modulation_set_arpeggio(channel, 0x37, 4);
+		modulation_set_portamento(channel, 8);
+		modulation_set_pwm(channel, 64, 3);
+		modulation_set_volume_slide(channel, (channel & 1) ? 1 : -1);
+		modulation_set_note(channel, NOTE_C3 + next_random() % 48);
+	}
+}
+
+static void run_modulation_update(void) {
+	for (uint16_t i = 0; i < BATCH_SIZE; ++i)
+		modulation_update();
+	result += mixer.channels[0].oscillator.tunning_word;
+}
+#endif
+
+/* Waveform names */
+static const char *waveform_names[] = { "none", "sinus", "triangle", "square", "sawtooth", "noise", "dc" };
+
+/* Opcodes of the tracker_fetch_execute() kernel */
+static const struct {
+	uint8_t opcode;
+	const char *name;
+} opcodes[] = {
+	{ NO_ACTION, "NO_ACTION" },
+	{ SET_TEMPO, "SET_TEMPO" },
+	{ SET_WAVE, "SET_WAVE" },
+	{ SET_VOLUME, "SET_VOLUME" },
+	{ SET_GLOBAL_VOLUME, "SET_GLOBAL_VOLUME" },
+	{ NOTE_ON, "NOTE_ON" },
+	{ NOTE_OFF, "NOTE_OFF" },
+	{ END_OF_STREAM, "END_OF_STREAM" },
+	{ SOFTWARE_RESET, "SOFTWARE_RESET" },
+	{ SYNC_OSCILLATOR, "SYNC_OSCILLATOR" },
+	{ RESET_OSCILLATOR, "RESET_OSCILLATOR" },
+	{ SET_ADSR, "SET_ADSR" },
+	{ JUMP_IN_FILE, "JUMP_IN_FILE" },
+	{ SET_DUTY, "SET_DUTY" },
+	{ DIRECT_EXEC, "DIRECT_EXEC (4 x NO_ACTION)" },
+	{ SET_ADSR_VALUES, "SET_ADSR_VALUES" },
+#ifdef INSTRUMENT_BANK
+	{ SET_INSTRUMENT, "SET_INSTRUMENT" },
+#endif
+};
+
+/* Program entry point */
+int main(void) {
+	if (!song_writer_init(&song)) {
+		perror("Unable to allocate opcodes stream");
+		return 1;
+	}
+	engine_reset();
+
+	measure("loop", "", NULL, run_loop);
+
+	/* Oscillator */
+	for (parameter = WF_NONE; parameter <= WF_DC; ++parameter)
+		measure("get_waveform_sample", waveform_names[parameter], prepare_oscillators, run_waveform_sample);
+	parameter = WF_SINUS;
+	measure("prepare_next_sample", "", prepare_oscillators, run_prepare_next_sample);
+
+	/* Envelope */
+	parameter = ENVELOPE_NONE;
+	measure("get_envelope_sample", "ADSR_NONE", prepare_envelopes, run_envelope_sample);
+	parameter = ENV_ATTACK;
+	measure("get_envelope_sample", "attack", prepare_envelopes, run_envelope_sample);
+	parameter = ENV_DECAY;
+	measure("get_envelope_sample", "decay", prepare_envelopes, run_envelope_sample);
+	parameter = ENV_SUSTAIN;
+	measure("get_envelope_sample", "sustain", prepare_envelopes, run_envelope_sample);
+	parameter = ENV_RELEASE;
+	measure("get_envelope_sample", "release", prepare_envelopes, run_envelope_sample);
+	parameter = ENVELOPE_ENDED;
+	measure("get_envelope_sample", "ended", prepare_envelopes, run_envelope_sample);
+
+	/* Gain and mapping */
+	measure("scale_value", "SCALE_WITH_AUTO_OFFSET", prepare_scale_values, run_scale_auto_offset);
+	measure("scale_value", "truncate", prepare_scale_values, run_scale_truncate);
+	measure("map_sample", "", prepare_mix_values, run_map_sample);
+
+	/* Gain stages */
+	static char table_variant[32];
+	snprintf(table_variant, sizeof(table_variant), "SCALE_GAIN_TABLE (%u steps)", GAIN_TABLE_STEPS);
+	measure("gain", "multiply", prepare_scale_values, run_gain_multiply);
+	measure("gain", "software multiply", prepare_scale_values, run_gain_software_multiply);
+	measure("gain", "SCALE_SHIFT_ADD", prepare_scale_values, run_gain_shift_add);
+	measure("gain", table_variant, prepare_scale_values, run_gain_table);
+	gain_error("software multiply", gain_software_multiply);
+	gain_error("SCALE_SHIFT_ADD", gain_shift_add);
+	gain_error(table_variant, gain_lookup);
+
+	/* Tracker */
+	for (uint8_t i = 0; i < sizeof(opcodes) / sizeof(opcodes[0]); ++i) {
+		parameter = opcodes[i].opcode;
+		write_opcode_stream();
+		if (song.overflow) {
+			fprintf(stderr, "Opcodes stream too long\n");
+			song_writer_free(&song);
+			return 1;
+		}
+		measure("tracker_fetch_execute", opcodes[i].name, prepare_tracker, run_tracker);
+	}
+
+	tracker_load_song(NULL, 0);
+	song_writer_free(&song);
+
+	/* Output paths */
+	measure("mixer_render_sample", "u8", prepare_render, run_render_u8);
+#ifdef OUTPUT_DITHER
+	measure("mixer_render_sample", "s16 (dither)", prepare_render, run_render_s16);
+#else
+	measure("mixer_render_sample", "s16", prepare_render, run_render_s16);
+#endif
+	measure("mixer_render_sample", "f32", prepare_render, run_render_f32);
+
+#ifdef MODULATION
+	/* Modulators (one update every MODULATION_RATE samples) */
+	measure("modulation_update", "all modulators", prepare_modulation, run_modulation_update);
+	measure("mixer_render_sample", "u8 (all modulators)", prepare_modulation, run_render_u8);
+#endif
+	return 0;
+}
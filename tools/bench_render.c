@@ -0,0 +1,267 @@
+/**
+ * @file bench_render.c
+ * @brief Generic digital chiptune generator - End-to-end render benchmark
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool render the bundled tracker file and synthetic tracker files to a SINK_NULL output sink
+ * and print one JSON object per case on stdout : samples/s, ns per sample per channel and real-time factor.\n
+ * Synthetic tracker files play every channel (one note on / note off per channel every 4 rows)
+ * with each waveform mix, with and without ADSR envelope, channels above 15 are addressed by CHANNEL_PREFIX.\n
+ * With VOICE_POOL they play VOICE_LOGICAL_CHANNELS logical channels on NUMBERS_OF_CHANNEL voices (voice allocation and stealing).\n
+ * Worst-case tracker files (see workload.h) are written from a seed, the workload field is the workload name (waveforms and adsr fields are null).\n
+ * Besides the average cost, the cost of the slowest block of BLOCK_SIZE samples is reported (max_block_ns_per_sample, average ns per sample of this block, not a per-sample maximum).\n
+ * NUMBERS_OF_CHANNEL and SAMPLE_RATE are compile-time settings, build once per configuration
+ * with -DNUMBERS_OF_CHANNEL=n -DSAMPLE_RATE=r (bench_render.sh sweep them).\n
+ * Usage : bench_render [seconds of song per case] [minimum seconds of measure per case] [workload seed]\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Build with the linux port and RENDER_API defined (see README.md)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>           // For hardcoded type
+#include <stdio.h>            // For printf
+#include <stdlib.h>           // For atof
+#include <time.h>             // For clock_gettime
+#include "../common.h"        // For common macro
+#include "../port.h"          // For platform dependent macro
+#include "../tracker.h"       // For tracker commands
+#include "../tracker_data.h"  // For english note notation
+#include "../subtimer.h"      // For SubTimer structure
+#include "../envelope.h"      // For ADSR envelope name
+#include "../oscillator.h"    // For Waveform name
+#include "../mixer.h"         // For channel name
+#include "../modulation.h"    // For modulators
+#include "../voice.h"         // For voice pool
+#include "../render.h"        // For render session
+#include "song_writer.h"      // For synthetic tracker files
+#include "workload.h"         // For worst-case tracker files
+
+#ifndef RENDER_API
+#error "bench_render need RENDER_API (build with -DRENDER_API)"
+#endif
+
+/* Nanoseconds per second */
+#define NS_PER_SECOND 1000000000ULL
+
+/* Size of one render block (in samples, 32ms @8KHz) */
+#define BLOCK_SIZE 256
+
+/* Tempo of synthetic tracker files (in BPM, one row per beat) */
+#define SYNTHETIC_TEMPO 600
+
+/* Number of rows of synthetic tracker files (before jump to first row) */
+#define SYNTHETIC_ROWS 64
+
+/* Waveform mixes of synthetic tracker files */
+typedef struct {
+	const char *name;
+	uint8_t waveforms[5]; // Waveform of channel n is waveforms[n % count]
+	uint8_t count;
+} Waveform_mix_t;
+
+static const Waveform_mix_t waveform_mixes[] = {
+	{ "sinus", { WF_SINUS }, 1 },
+	{ "triangle", { WF_TRIANGLE }, 1 },
+	{ "square", { WF_SQUARE }, 1 },
+	{ "sawtooth", { WF_SAWTOOTH }, 1 },
+	{ "noise", { WF_NOISE }, 1 },
+	{ "mixed", { WF_SINUS, WF_TRIANGLE, WF_SQUARE, WF_SAWTOOTH, WF_NOISE }, 5 }
+};
+
+/* Number of channels of synthetic tracker files (logical channels of the voice pool, setup fit in one DIRECT_EXEC) */
+#ifdef VOICE_POOL
+#define SYNTHETIC_CHANNELS ((VOICE_LOGICAL_CHANNELS < 84) ? VOICE_LOGICAL_CHANNELS : 84)
+#else
+#define SYNTHETIC_CHANNELS ((NUMBERS_OF_CHANNEL < 84) ? NUMBERS_OF_CHANNEL : 84)
+#endif
+
+/* Number of opcodes per row of synthetic tracker files (at least one per channel) */
+#define SYNTHETIC_ROW_LENGTH ((SYNTHETIC_CHANNELS > NUMBERS_OF_CHANNEL) ? SYNTHETIC_CHANNELS : NUMBERS_OF_CHANNEL)
+
+/* Get monotonic time in nanoseconds */
+static inline uint64_t get_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+/* Write a synthetic tracker file */
+static void write_synthetic_song(Song_writer_t *song, const Waveform_mix_t *mix, uint8_t adsr) {
+	uint8_t channels = SYNTHETIC_CHANNELS;
+
+	/* Setup (executed at startup) */
+	song->length = 0;
+	song_put_byte(song, DIRECT_EXEC);
+	song_put_byte(song, 3 + channels * 3);
+	song_put_byte(song, SET_TEMPO);
+	song_put_word(song, SYNTHETIC_TEMPO);
+	song_put_byte(song, SET_GLOBAL_VOLUME);
+	song_put_byte(song, 255);
+	song_put_adsr_values(song, ADSR_USER_1, 20, 40, 160, 60);
+	for (uint8_t channel = 0; channel < channels; ++channel) {
+		song_put_channel_opcode(song, SET_WAVE, channel);
+		song_put_byte(song, mix->waveforms[channel % mix->count]);
+		song_put_channel_opcode(song, SET_VOLUME, channel);
+		song_put_byte(song, 255);
+		song_put_channel_opcode(song, SET_ADSR, channel);
+		song_put_byte(song, adsr ? ADSR_USER_1 : ADSR_NONE);
+	}
+
+	/* Rows (one opcode per channel, NUMBERS_OF_CHANNEL opcodes are executed per tick) */
+	uint16_t first_row = song->length;
+	for (uint8_t row = 0; row < SYNTHETIC_ROWS; ++row) {
+		for (uint8_t channel = 0; channel < SYNTHETIC_ROW_LENGTH; ++channel) {
+			if (channel >= channels) {
+				song_put_byte(song, NO_ACTION);
+			} else if ((row & 3) == (channel & 3)) {
+				song_put_channel_opcode(song, NOTE_ON, channel);
+				song_put_byte(song, NOTE_C4 + ((row + channel * 5) % 36));
+			} else if ((row & 3) == ((channel + 2) & 3)) {
+				song_put_channel_opcode(song, NOTE_OFF, channel);
+			} else {
+				song_put_byte(song, NO_ACTION);
+			}
+		}
+	}
+
+	/* Loop forever (the render session stop on duration limit) */
+	song_put_byte(song, JUMP_IN_FILE);
+	song_put_word(song, first_row);
+}
+
+/* Render the current tracker file to the null sink until minimum measure time, print result (workload_name NULL for waveform mix cases) */
+static uint8_t run_case(const char *song_name, const char *workload_name, const char *mix_name, uint8_t adsr, uint32_t max_samples, uint64_t min_ns) {
+	static uint8_t block[BLOCK_SIZE];
+	const Render_limits_t limits = { max_samples, 0 };
+	const Sink_format_t format = { SAMPLE_RATE, 1, 8 };
+	Render_session_t session;
+	Sink_t sink;
+	uint64_t samples = 0;
+	uint64_t max_block_ns = 0;
+	uint32_t max_block_length = 1;
+	uint32_t runs = 0;
+
+	if (!sink_open(&sink, SINK_NULL, NULL, &format))
+		return 0;
+
+	/* Render the song again and again, at least min_ns */
+	uint64_t start = get_time_ns();
+	uint64_t elapsed;
+	do {
+		render_start(&session, &limits);
+		while (session.status == RENDER_OK) {
+			uint64_t block_start = get_time_ns();
+			uint32_t length = render_samples(&session, block, BLOCK_SIZE);
+			sink_write(&sink, block, length);
+			uint64_t block_ns = get_time_ns() - block_start;
+			if (length && block_ns * max_block_length > max_block_ns * length) {
+				max_block_ns = block_ns;
+				max_block_length = length;
+			}
+			samples += length;
+		}
+		++runs;
+		elapsed = get_time_ns() - start;
+	} while (elapsed < min_ns);
+	sink_close(&sink);
+
+	/* Print result (JSON lines) */
+	double seconds = (double)elapsed / NS_PER_SECOND;
+	printf("{\"song\": \"%s\", ", song_name);
+	if (workload_name) // Workload tracker files mix every waveform, with or without ADSR
+		printf("\"workload\": \"%s\", \"waveforms\": null, \"adsr\": null, ", workload_name);
+	else
+		printf("\"workload\": null, \"waveforms\": \"%s\", \"adsr\": %d, ", mix_name, adsr);
+	printf("\"channels\": %u, \"sample_rate\": %lu, "
+			"\"runs\": %u, \"samples\": %llu, \"elapsed_ns\": %llu, \"samples_per_second\": %.0f, "
+			"\"ns_per_sample_per_channel\": %.3f, \"max_block_ns_per_sample\": %.1f, \"realtime_factor\": %.1f}\n",
+			NUMBERS_OF_CHANNEL, (unsigned long)SAMPLE_RATE,
+			runs, (unsigned long long)samples, (unsigned long long)elapsed, samples / seconds,
+			(double)elapsed / samples / NUMBERS_OF_CHANNEL, (double)max_block_ns / max_block_length,
+			samples / seconds / SAMPLE_RATE);
+	fflush(stdout);
+	return 1;
+}
+
+/* Program entry point */
+int main(int argc, char **argv) {
+	double song_seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+	double min_seconds = (argc > 2) ? atof(argv[2]) : 0.5;
+	uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 0) : 1;
+	uint32_t max_samples = song_seconds * SAMPLE_RATE;
+	uint64_t min_ns = min_seconds * NS_PER_SECOND;
+	Song_writer_t song;
+
+	if (max_samples == 0) {
+		fprintf(stderr, "Usage: %s [seconds of song per case] [minimum seconds of measure per case] [workload seed]\n", argv[0]);
+		return 1;
+	}
+	if (!song_writer_init(&song)) {
+		perror("Unable to allocate tracker file");
+		return 1;
+	}
+
+	/* Bundled tracker file (use 6 channels with ADSR, until END_OF_STREAM) */
+	if (NUMBERS_OF_CHANNEL >= 6) {
+		tracker_load_song(NULL, 0);
+		if (!run_case("bundled", NULL, "sinus", 1, 0, min_ns))
+			goto sink_error;
+	}
+
+	/* Synthetic tracker files */
+	for (uint8_t mix = 0; mix < sizeof(waveform_mixes) / sizeof(waveform_mixes[0]); ++mix) {
+		for (uint8_t adsr = 0; adsr < 2; ++adsr) {
+			write_synthetic_song(&song, waveform_mixes + mix, adsr);
+			if (song.overflow) {
+				fprintf(stderr, "Synthetic tracker file too long\n");
+				song_writer_free(&song);
+				return 1;
+			}
+			tracker_load_song(song.opcodes, song.length);
+			if (!run_case("synthetic", NULL, waveform_mixes[mix].name, adsr, max_samples, min_ns))
+				goto sink_error;
+		}
+	}
+
+	/* Worst-case tracker files */
+	for (uint8_t workload = 0; workload < WORKLOAD_COUNT; ++workload) {
+		if (!workload_write(&song, workload, seed, WORKLOAD_DEFAULT_ROWS)) {
+			fprintf(stderr, "Workload tracker file too long\n");
+			song_writer_free(&song);
+			return 1;
+		}
+		tracker_load_song(song.opcodes, song.length);
+		if (!run_case("workload", workload_names[workload], NULL, 0, max_samples, min_ns))
+			goto sink_error;
+	}
+
+	tracker_load_song(NULL, 0);
+	song_writer_free(&song);
+	return 0;
+
+sink_error:
+	perror("Unable to open null sink");
+	song_writer_free(&song);
+	return 1;
+}
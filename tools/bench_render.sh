@@ -0,0 +1,28 @@
+#!/bin/sh
+# Generic digital chiptune generator - End-to-end render benchmark sweep
+# Build bench_render (see bench_render.c) for each number of channels and sample rate, with the linux port,
+# and print all results as JSON lines on stdout.
+# Usage (from the main project directory) : tools/bench_render.sh [seconds of song per case] [minimum seconds of measure per case] [workload seed]
+# CHANNELS, SAMPLE_RATES and CFLAGS can be overridden from the environment.
+# Channels above 15 are addressed by CHANNEL_PREFIX, the tick budget is raised above the number of channels.
+# Add -DVOICE_POOL to CFLAGS to play the logical channels on a voice pool (see voice.h).
+
+CHANNELS=${CHANNELS:-"1 2 4 6 8 12 16 32 64"}
+SAMPLE_RATES=${SAMPLE_RATES:-"8000 16000 22050 44100"}
+CFLAGS=${CFLAGS:-"-std=gnu99 -O2"}
+
+# Build in a temporary copy of the sources (port.h of the main project directory is left untouched)
+BUILD=$(mktemp -d) || exit 1
+trap 'rm -rf "$BUILD"' EXIT
+mkdir "$BUILD/tools"
+cp *.c *.h "$BUILD/" && cp "ports/(linux)port.h" "$BUILD/port.h" && cp tools/*.c tools/*.h "$BUILD/tools/" || exit 1
+rm "$BUILD/main.c"
+
+for channels in $CHANNELS; do
+	for rate in $SAMPLE_RATES; do
+		budget=$((channels < 64 ? 64 : channels * 2))
+		(cd "$BUILD" && gcc $CFLAGS -DRENDER_API -DNUMBERS_OF_CHANNEL=$channels -DTRACKER_TICK_BUDGET=$budget -DSAMPLE_RATE=${rate}UL \
+			tools/bench_render.c tools/song_writer.c tools/workload.c *.c -o bench_render -lrt) || exit 1
+		"$BUILD/bench_render" "$@" || exit 1
+	done
+done
@@ -0,0 +1,39 @@
+/*
+ * See bench_kernels.c for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>          // For hardcoded type
+#include "../common.h"       // For common macro
+
+/* scale_value() is inline and configured at compile time, build this file without SCALE_WITH_AUTO_OFFSET */
+#undef SCALE_WITH_AUTO_OFFSET
+
+#include "../port.h"         // For platform dependent macro
+#include "../tracker.h"      // For tracker commands
+#include "../tracker_data.h" // For english note notation
+#include "../subtimer.h"     // For SubTimer structure
+#include "../envelope.h"     // For ADSR envelope name
+#include "../oscillator.h"   // For Waveform name
+#include "../mixer.h"        // For scale_value
+
+/* Scale count values (truncate mode), return sum of results */
+uint32_t bench_scale_truncate(const uint16_t *values, const uint16_t *scales, uint32_t count) {
+	uint32_t sum = 0;
+	for (uint32_t i = 0; i < count; ++i)
+		sum += scale_value(values[i], scales[i]);
+	return sum;
+}
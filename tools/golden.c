@@ -0,0 +1,410 @@
+/**
+ * @file golden.c
+ * @brief Generic digital chiptune generator - Bit-exact golden reference harness
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool render the bundled tracker file through every render path and compare each render,
+ * byte per byte, with the reference outputs of the samples directory :
+ * - output_adsr.raw : bundled tracker file
+ * - output_no_adsr.raw : bundled tracker file with every SET_ADSR set to ADSR_NONE
+ *
+ * Render paths : sampling ISR (like main), render session by blocks of 1, 256 and 4096 samples,
+ * checkpointed render, incremental render after an edit, render with stems (when built with STEM_OUTPUT),
+ * threaded and offline players (when built with PLAYER_OUTPUT), fan-out output (when built with FANOUT_OUTPUT).\n
+ * On mismatch the first diverging sample and the engine state just before it (render session) are printed.\n
+ * Usage : golden [samples directory]\n
+ * Return 0 if every render path is bit-exact, 1 otherwise.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Build with the linux port and RENDER_API defined (see README.md)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>          // For hardcoded type
+#include <stdio.h>           // For file I/O
+#include <stdlib.h>          // For malloc
+#include <string.h>          // For memcpy
+#include "../common.h"       // For common macro
+#include "../port.h"         // For platform dependent macro
+#include "../tracker.h"      // For tracker commands
+#include "../tracker_data.h" // For english note notation
+#include "../subtimer.h"     // For SubTimer structure
+#include "../envelope.h"     // For ADSR envelope name
+#include "../oscillator.h"   // For Waveform name
+#include "../mixer.h"        // For channel name
+#include "../modulation.h"   // For modulators
+#include "../voice.h"        // For voice pool
+#include "../render.h"       // For render session
+#ifdef PLAYER_OUTPUT
+#include "../player.h"       // For player run modes
+#endif
+#ifdef FANOUT_OUTPUT
+#include "../fanout.h"       // For fan-out output
+#endif
+
+#ifndef RENDER_API
+#error "golden need RENDER_API (build with -DRENDER_API)"
+#endif
+
+/* Sampling ISR (see mixer.c) */
+extern TIMER_ISR_FUNCTION;
+
+/* Maximum length of a render (longer than any reference output) */
+#define MAX_RENDER_LENGTH (4UL * 1024 * 1024)
+
+/* Number of samples printed around the first diverging sample */
+#define CONTEXT_SAMPLES 4
+
+/* Number of arguments bytes of each opcode (opcode >> 4) */
+static const uint8_t opcode_arguments[16] = { 0, 2, 1, 1, 1, 1, 0, 0, 0, 1, 0, 1, 2, 1, 1, 7 };
+
+/* Number of arguments bytes of an opcode (extended opcodes included) */
+static inline uint8_t get_opcode_arguments(uint8_t opcode) {
+	if (opcode == SET_PAN)
+		return 2;
+	if (opcode == CHANNEL_PREFIX || opcode == SET_VOICES)
+		return 1; // The opcode after a channel prefix is walked on its own
+	if (opcode == SET_INSTRUMENT)
+		return 2;
+	if (opcode == SET_INSTRUMENT_VALUES)
+		return 5;
+	if (opcode == SET_VIBRATO || opcode == SET_ARPEGGIO || opcode == SET_PWM)
+		return 3;
+	if (opcode == SET_PORTAMENTO || opcode == SET_VOLUME_SLIDE)
+		return 2;
+	return opcode_arguments[opcode >> 4];
+}
+
+/* Render buffer */
+typedef struct {
+	uint8_t *samples;
+	uint32_t length;
+} Buffer_t;
+
+/* Render path */
+typedef struct {
+	const char *name;
+	uint8_t (*render)(Buffer_t *buffer); // Return 1 on success, 0 on error
+} Render_path_t;
+
+/* Render with the sampling ISR into a memory sink (same startup sequence as main) */
+static uint8_t render_isr(Buffer_t *buffer) {
+	const Sink_format_t format = { SAMPLE_RATE, 1, 8 };
+	if (!sink_open(&output_sink, SINK_MEMORY, NULL, &format))
+		return 0;
+
+	engine_reset();
+	tracker_fetch_execute();
+	while (!tracker_end_of_stream && output_sink.length + output_sink.block_fill < MAX_RENDER_LENGTH)
+		sampling_fnct();
+	sink_close(&output_sink);
+
+	buffer->length = output_sink.length;
+	memcpy(buffer->samples, output_sink.memory, buffer->length);
+	sink_free_memory(&output_sink);
+	return !output_sink.error;
+}
+
+/* Render with a render session, by blocks of block_size samples */
+static uint8_t render_blocks(Buffer_t *buffer, uint32_t block_size) {
+	const Render_limits_t limits = { MAX_RENDER_LENGTH, 0 };
+	Render_session_t session;
+
+	render_start(&session, &limits);
+	buffer->length = 0;
+	while (session.status == RENDER_OK)
+		buffer->length += render_samples(&session, buffer->samples + buffer->length, block_size);
+	return 1;
+}
+
+static uint8_t render_block_1(Buffer_t *buffer) {
+	return render_blocks(buffer, 1);
+}
+
+static uint8_t render_block_256(Buffer_t *buffer) {
+	return render_blocks(buffer, 256);
+}
+
+static uint8_t render_block_4096(Buffer_t *buffer) {
+	return render_blocks(buffer, 4096);
+}
+
+/* Render with checkpoints, then render again after an edit of edit_first to edit_last (if edit_last >= edit_first) */
+static uint8_t render_checkpointed(Buffer_t *buffer, uint16_t edit_first, uint16_t edit_last) {
+	Render_t render;
+	if (!render_init(&render, MAX_RENDER_LENGTH))
+		return 0;
+
+	render_song(&render);
+	if (edit_last >= edit_first)
+		render_incremental(&render, edit_first, edit_last);
+
+	buffer->length = render.length;
+	memcpy(buffer->samples, render.samples, buffer->length);
+	render_free(&render);
+	return 1;
+}
+
+static uint8_t render_checkpoint(Buffer_t *buffer) {
+	return render_checkpointed(buffer, 1, 0);
+}
+
+/* Edit (without change) one byte in the middle of the song : render again from the checkpoint before the first read */
+static uint8_t render_incremental_edit(Buffer_t *buffer) {
+	uint16_t middle = tracker_music_length / 2;
+	return render_checkpointed(buffer, middle, middle);
+}
+
+#ifdef STEM_OUTPUT
+/* Render with the stems of every channel in the same pass (the mix must not change) */
+static uint8_t render_stems_4096(Buffer_t *buffer) {
+	const Render_limits_t limits = { MAX_RENDER_LENGTH, 0 };
+	static uint8_t stem_blocks[NUMBERS_OF_CHANNEL][4096];
+	uint8_t *stems[NUMBERS_OF_CHANNEL];
+	Render_session_t session;
+
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel)
+		stems[channel] = stem_blocks[channel];
+	render_start(&session, &limits);
+	buffer->length = 0;
+	while (session.status == RENDER_OK)
+		buffer->length += render_stems(&session, buffer->samples + buffer->length, stems, 4096);
+	return 1;
+}
+#endif
+
+#ifdef PLAYER_OUTPUT
+/* Render with a player into a memory sink */
+static uint8_t render_player(Buffer_t *buffer, uint8_t (*run)(const Player_config_t *, Player_stats_t *)) {
+	const Sink_format_t format = { SAMPLE_RATE, 1, 8 };
+	const Player_config_t config = {
+		PLAYER_BLOCK_SIZE, PLAYER_RING_DEPTH, PLAYER_HIGH_WATERMARK, PLAYER_LOW_WATERMARK,
+		{ MAX_RENDER_LENGTH, 0 }
+	};
+	Player_stats_t stats;
+
+	if (!sink_open(&output_sink, SINK_MEMORY, NULL, &format))
+		return 0;
+	uint8_t success = run(&config, &stats);
+	sink_close(&output_sink);
+
+	buffer->length = output_sink.length;
+	memcpy(buffer->samples, output_sink.memory, buffer->length);
+	sink_free_memory(&output_sink);
+	return success;
+}
+
+static uint8_t render_threaded(Buffer_t *buffer) {
+	return render_player(buffer, player_run_threaded);
+}
+
+static uint8_t render_offline(Buffer_t *buffer) {
+	return render_player(buffer, player_run_offline);
+}
+#endif
+
+#ifdef FANOUT_OUTPUT
+/* Render once to a memory sink (8 bits) and a null sink (16 bits) concurrently */
+static uint8_t render_fanout(Buffer_t *buffer) {
+	const Sink_format_t format = { SAMPLE_RATE, 1, 8 };
+	const Sink_format_t wide_format = { SAMPLE_RATE, 1, 16 };
+	const Player_config_t config = {
+		PLAYER_BLOCK_SIZE, PLAYER_RING_DEPTH, PLAYER_HIGH_WATERMARK, PLAYER_LOW_WATERMARK,
+		{ MAX_RENDER_LENGTH, 0 }
+	};
+	Player_stats_t stats;
+	Sink_t wide_sink;
+
+	if (!sink_open(&output_sink, SINK_MEMORY, NULL, &format))
+		return 0;
+	if (!sink_open(&wide_sink, SINK_NULL, NULL, &wide_format)) {
+		sink_close(&output_sink);
+		sink_free_memory(&output_sink);
+		return 0;
+	}
+	Fanout_output_t outputs[] = {
+		{ .format = &fanout_format_u8, .sink = &output_sink },
+		{ .format = &fanout_format_s16, .sink = &wide_sink }
+	};
+	uint8_t success = fanout_run(&config, outputs, 2, &stats);
+	sink_close(&wide_sink);
+	sink_close(&output_sink);
+
+	buffer->length = output_sink.length;
+	memcpy(buffer->samples, output_sink.memory, buffer->length);
+	sink_free_memory(&output_sink);
+	return success && wide_sink.length == 2 * buffer->length;
+}
+#endif
+
+/* Render paths (add new render paths here) */
+static const Render_path_t render_paths[] = {
+	{ "isr", render_isr },
+	{ "block_1", render_block_1 },
+	{ "block_256", render_block_256 },
+	{ "block_4096", render_block_4096 },
+	{ "checkpoint", render_checkpoint },
+	{ "incremental", render_incremental_edit },
+#ifdef STEM_OUTPUT
+	{ "stems", render_stems_4096 },
+#endif
+#ifdef PLAYER_OUTPUT
+	{ "threaded", render_threaded },
+	{ "offline", render_offline },
+#endif
+#ifdef FANOUT_OUTPUT
+	{ "fanout", render_fanout },
+#endif
+};
+
+/* Load a reference output */
+static uint8_t load_reference(Buffer_t *buffer, const char *directory, const char *name) {
+	char filename[1024];
+	snprintf(filename, sizeof(filename), "%s/%s", directory, name);
+
+	FILE *file = fopen(filename, "rb");
+	if (!file) {
+		perror(filename);
+		return 0;
+	}
+	buffer->length = fread(buffer->samples, 1, MAX_RENDER_LENGTH, file);
+	fclose(file);
+	return 1;
+}
+
+/* Print the engine state just before sample position (render again until position) */
+static void print_engine_state(uint32_t position) {
+	static uint8_t block[4096];
+	const Render_limits_t limits = { position, 0 };
+	Render_session_t session;
+	Engine_state_t state;
+
+	render_start(&session, &limits);
+	while (position && render_samples(&session, block, sizeof(block)))
+		; // No limit for position 0
+	engine_save_state(&state);
+
+	printf("  engine state before sample %u :\n", position);
+	printf("    tracker index %u, tempo timer %u / %u, global volume %u, noise seed 0x%08X\n",
+			state.tracker_index, state.tempo_timer.tick_counter, state.tempo_timer.tick_compare,
+			state.mixer.global_volume, state.noise_seed);
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		const Channel_t *current = &(state.mixer.channels[channel]);
+		printf("    channel %u : volume %u, waveform %u, duty %u, tunning word %u, phase %u, "
+				"ADSR %u state %u ended %u value %u timer %u / %u\n",
+				channel, current->volume, current->oscillator.waveform, current->oscillator.duty,
+				current->oscillator.tunning_word, current->oscillator.phase_accumulator,
+				current->envelope.type, current->envelope.state, current->envelope.ended, current->envelope.value,
+				current->envelope.value_change_timer.tick_counter, current->envelope.value_change_timer.tick_compare);
+	}
+}
+
+/* Compare a render with the reference output, print result, return 1 if bit-exact */
+static uint8_t compare(const char *path, const Buffer_t *render, const Buffer_t *reference) {
+	uint32_t length = (render->length < reference->length) ? render->length : reference->length;
+	uint32_t position;
+	for (position = 0; position < length && render->samples[position] == reference->samples[position]; ++position)
+		;
+
+	if (position == length && render->length == reference->length) {
+		printf("  %-12s OK (%u samples)\n", path, render->length);
+		return 1;
+	}
+
+	/* Report first diverging sample */
+	if (position == length)
+		printf("  %-12s FAIL : length %u, expected %u\n", path, render->length, reference->length);
+	else
+		printf("  %-12s FAIL : first diverging sample %u (%.3f s), got %u, expected %u\n", path,
+				position, (double)position / SAMPLE_RATE, render->samples[position], reference->samples[position]);
+	uint32_t first = (position > CONTEXT_SAMPLES) ? position - CONTEXT_SAMPLES : 0;
+	printf("  got      :");
+	for (uint32_t i = first; i < position + CONTEXT_SAMPLES && i < render->length; ++i)
+		printf(" %3u", render->samples[i]);
+	printf("\n  expected :");
+	for (uint32_t i = first; i < position + CONTEXT_SAMPLES && i < reference->length; ++i)
+		printf(" %3u", reference->samples[i]);
+	printf("\n");
+	print_engine_state(position);
+	return 0;
+}
+
+/* Check every render path against a reference output, return 1 if all are bit-exact */
+static uint8_t check_reference(const char *directory, const char *name, Buffer_t *render, Buffer_t *reference) {
+	if (!load_reference(reference, directory, name))
+		return 0;
+	printf("%s\n", name);
+
+	uint8_t success = 1;
+	for (uint8_t path = 0; path < sizeof(render_paths) / sizeof(render_paths[0]); ++path) {
+		if (!render_paths[path].render(render)) {
+			printf("  %-12s ERROR : render failed\n", render_paths[path].name);
+			success = 0;
+		} else if (!compare(render_paths[path].name, render, reference)) {
+			success = 0;
+		}
+	}
+	return success;
+}
+
+/* Copy the bundled tracker file with every SET_ADSR set to ADSR_NONE */
+static uint8_t *copy_without_adsr(void) {
+	uint8_t *opcodes = malloc(tracker_music_length);
+	if (!opcodes)
+		return NULL;
+
+	for (uint16_t i = 0; i < tracker_music_length; ++i)
+		opcodes[i] = get_byte_from_tracker(i);
+	for (uint16_t i = 0; i < tracker_music_length; i += 1 + get_opcode_arguments(opcodes[i])) {
+		if ((opcodes[i] & 0xF0) == SET_ADSR && i + 1 < tracker_music_length)
+			opcodes[i + 1] = ADSR_NONE;
+	}
+	return opcodes;
+}
+
+/* Program entry point */
+int main(int argc, char **argv) {
+	const char *directory = (argc > 1) ? argv[1] : "samples";
+	Buffer_t render = { malloc(MAX_RENDER_LENGTH), 0 };
+	Buffer_t reference = { malloc(MAX_RENDER_LENGTH), 0 };
+	uint8_t *no_adsr = copy_without_adsr();
+	if (!render.samples || !reference.samples || !no_adsr) {
+		perror("Unable to allocate buffers");
+		return 1;
+	}
+
+	/* Bundled tracker file */
+	tracker_load_song(NULL, 0);
+	uint8_t success = check_reference(directory, "output_adsr.raw", &render, &reference);
+
+	/* Without ADSR */
+	tracker_load_song(no_adsr, tracker_music_length);
+	success &= check_reference(directory, "output_no_adsr.raw", &render, &reference);
+	tracker_load_song(NULL, 0);
+
+	printf(success ? "All render paths are bit-exact\n" : "Some render paths differ from reference outputs\n");
+	free(no_adsr);
+	free(render.samples);
+	free(reference.samples);
+	return success ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file shm_consumer.c
+ * @brief Generic digital chiptune generator - Shared memory ring reference consumer
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool read samples from the shared memory ring of the SINK_SHM output sink and write them to a file or stdout.\n
+ * Usage : shm_consumer /chiptune [output.raw]\n
+ * The stream format is printed on stderr, the shared memory object is removed at end of stream.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include <stdio.h>        // For file I/O
+#include <unistd.h>       // For usleep
+#include "../shm_ring.h"  // For shared memory ring
+
+/* Number of attempts to open the shared memory object (every 10ms) */
+#define OPEN_ATTEMPTS 500
+
+/* Program entry point */
+int main(int argc, char **argv) {
+	Shm_ring_t ring;
+
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s name [output file]\n", argv[0]);
+		return 1;
+	}
+
+	/* Wait for producer */
+	uint16_t attempt;
+	for (attempt = 0; attempt < OPEN_ATTEMPTS && !shm_ring_open(&ring, argv[1]); ++attempt)
+		usleep(10000);
+	if (attempt == OPEN_ATTEMPTS) {
+		fprintf(stderr, "Unable to open shared memory ring %s\n", argv[1]);
+		return 1;
+	}
+	fprintf(stderr, "%u Hz, %u channel(s), %u bits\n", ring.header->sample_rate, ring.header->channels, ring.header->bits_per_sample);
+
+	/* Open output file */
+	FILE *output = (argc > 2) ? fopen(argv[2], "wb") : stdout;
+	if (!output) {
+		fprintf(stderr, "Unable to open file %s\n", argv[2]);
+		shm_ring_close(&ring);
+		return 1;
+	}
+
+	/* Read samples in place until end of stream */
+	const uint8_t *samples;
+	uint32_t length;
+	uint64_t total = 0;
+	while ((samples = shm_ring_peek(&ring, &length))) {
+		fwrite(samples, 1, length, output);
+		shm_ring_consume(&ring, length);
+		total += length;
+	}
+	fprintf(stderr, "%llu bytes\n", (unsigned long long)total);
+
+	/* Cleanup */
+	if (output != stdout)
+		fclose(output);
+	shm_ring_close(&ring);
+	shm_ring_unlink(argv[1]);
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include <stdlib.h>       // For malloc
+#include "../common.h"    // For common macro
+#include "../port.h"      // For platform dependent macro
+#include "../tracker.h"   // For tracker commands
+#include "song_writer.h"  // For song writer structure
+
+uint8_t song_writer_init(Song_writer_t *song) {
+	song->length = 0;
+	song->overflow = 0;
+	song->opcodes = malloc(SONG_WRITER_MAX_LENGTH);
+	return song->opcodes != NULL;
+}
+
+void song_writer_free(Song_writer_t *song) {
+	free(song->opcodes);
+	song->opcodes = NULL;
+	song->length = 0;
+}
+
+void song_put_byte(Song_writer_t *song, uint8_t value) {
+	if (song->length >= SONG_WRITER_MAX_LENGTH) {
+		song->overflow = 1;
+		return;
+	}
+	song->opcodes[song->length++] = value;
+}
+
+void song_put_word(Song_writer_t *song, uint16_t value) {
+	song_put_byte(song, high(value));
+	song_put_byte(song, low(value));
+}
+
+void song_put_channel_opcode(Song_writer_t *song, uint8_t opcode, uint8_t channel) {
+	if (channel > 0x0F) {
+		song_put_byte(song, CHANNEL_PREFIX);
+		song_put_byte(song, channel);
+		song_put_byte(song, opcode);
+	} else {
+		song_put_byte(song, opcode | channel);
+	}
+}
+
+void song_put_adsr_values(Song_writer_t *song, uint8_t envelope, uint16_t attack, uint16_t decay, uint8_t sustain_level, uint16_t release) {
+	song_put_channel_opcode(song, SET_ADSR_VALUES, envelope);
+	song_put_word(song, attack);
+	song_put_word(song, decay);
+	song_put_byte(song, sustain_level);
+	song_put_word(song, release);
+}
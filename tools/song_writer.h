@@ -0,0 +1,103 @@
+/**
+ * @file song_writer.h
+ * @brief Generic digital chiptune generator - Tracker file writer for tools
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle build a tracker file in memory (opcodes and their arguments),
+ * to be played with tracker_load_song() (see tracker.h).\n
+ * Words are stored high byte first, like the value() macro of the computer ports.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _SONG_WRITER_H_
+#define _SONG_WRITER_H_
+
+/**
+ * Maximum length of a tracker file (16 bits tracker index)
+ */
+#define SONG_WRITER_MAX_LENGTH 65535UL
+
+/**
+ * Song writer structure
+ */
+typedef struct {
+	uint8_t *opcodes;
+	uint16_t length;
+	uint8_t overflow; // Set if the tracker file doesn't fit in SONG_WRITER_MAX_LENGTH bytes
+} Song_writer_t;
+
+/**
+ * Allocate a Song_writer object
+ *
+ * @param song Pointer to a Song_writer_t object
+ * @return 1 on success, 0 if out of memory
+ */
+uint8_t song_writer_init(Song_writer_t *song);
+
+/**
+ * Free a Song_writer object
+ *
+ * @param song Pointer to a Song_writer_t object
+ */
+void song_writer_free(Song_writer_t *song);
+
+/**
+ * Append a byte (opcode or byte argument) to the tracker file
+ *
+ * @param song Pointer to a Song_writer_t object
+ * @param value Byte to append
+ */
+void song_put_byte(Song_writer_t *song, uint8_t value);
+
+/**
+ * Append a word (word argument) to the tracker file
+ *
+ * @param song Pointer to a Song_writer_t object
+ * @param value Word to append
+ */
+void song_put_word(Song_writer_t *song, uint16_t value);
+
+/**
+ * Append a channel opcode to the tracker file (CHANNEL_PREFIX for channels above 15)
+ *
+ * @param song Pointer to a Song_writer_t object
+ * @param opcode Opcode (low nibble cleared)
+ * @param channel Channel of opcode
+ * @remarks Arguments of the opcode are appended by the caller
+ */
+void song_put_channel_opcode(Song_writer_t *song, uint8_t opcode, uint8_t channel);
+
+/**
+ * Append a SET_ADSR_VALUES opcode to the tracker file
+ *
+ * @param song Pointer to a Song_writer_t object
+ * @param envelope ADSR envelope to setup
+ * @param attack Attack time in ms
+ * @param decay Decay time in ms
+ * @param sustain_level Sustain level
+ * @param release Release time in ms
+ */
+void song_put_adsr_values(Song_writer_t *song, uint8_t envelope, uint16_t attack, uint16_t decay, uint8_t sustain_level, uint16_t release);
+
+#endif // _SONG_WRITER_H_
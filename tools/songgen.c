@@ -0,0 +1,101 @@
+/**
+ * @file songgen.c
+ * @brief Generic digital chiptune generator - Worst-case tracker file generator
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool write a worst-case tracker file (see workload.h) on stdout, as raw opcodes
+ * or as a C array to paste into tracker_data.c (-c option).\n
+ * Usage : songgen [-c] workload [seed] [rows]\n
+ * Workloads : noise, note_storm, direct_exec, adsr_churn, tempo, mixed.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Build with the port of the target (NUMBERS_OF_CHANNEL and ADSR envelopes depend on common.h)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>          // For hardcoded type
+#include <stdio.h>           // For fwrite
+#include <stdlib.h>          // For strtoul
+#include <string.h>          // For strcmp
+#include "../common.h"       // For common macro
+#include "../port.h"         // For platform dependent macro
+#include "song_writer.h"     // For song writer structure
+#include "workload.h"        // For workload names
+
+/* Print usage and workload names */
+static void print_usage(const char *program) {
+	fprintf(stderr, "Usage: %s [-c] workload [seed] [rows]\nWorkloads:", program);
+	for (uint8_t workload = 0; workload < WORKLOAD_COUNT; ++workload)
+		fprintf(stderr, " %s", workload_names[workload]);
+	fprintf(stderr, "\n");
+}
+
+/* Program entry point */
+int main(int argc, char **argv) {
+	Song_writer_t song;
+	uint8_t c_array = 0;
+
+	/* Parse arguments */
+	if (argc > 1 && !strcmp(argv[1], "-c")) {
+		c_array = 1;
+		--argc;
+		++argv;
+	}
+	if (argc < 2) {
+		print_usage(argv[0]);
+		return 1;
+	}
+	uint8_t workload = workload_find(argv[1]);
+	uint32_t seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+	uint16_t rows = (argc > 3) ? strtoul(argv[3], NULL, 0) : WORKLOAD_DEFAULT_ROWS;
+	if (workload == WORKLOAD_COUNT) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	/* Write tracker file */
+	if (!song_writer_init(&song)) {
+		perror("Unable to allocate tracker file");
+		return 1;
+	}
+	if (!workload_write(&song, workload, seed, rows)) {
+		fprintf(stderr, "Tracker file too long\n");
+		song_writer_free(&song);
+		return 1;
+	}
+
+	/* Output tracker file */
+	if (c_array) {
+		printf("/* Workload %s, seed %lu, %u channels */\n", workload_names[workload], (unsigned long)seed, NUMBERS_OF_CHANNEL);
+		printf("const uint8_t tracker_music_opcodes[] PROGMEM = {");
+		for (uint16_t i = 0; i < song.length; ++i)
+			printf("%s0x%02X,", (i % 16) ? " " : "\n\t\t", song.opcodes[i]);
+		printf("\n};\n");
+	} else {
+		fwrite(song.opcodes, 1, song.length, stdout);
+	}
+	fprintf(stderr, "%u bytes\n", song.length);
+
+	song_writer_free(&song);
+	return 0;
+}
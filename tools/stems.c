@@ -0,0 +1,166 @@
+/**
+ * @file stems.c
+ * @brief Generic digital chiptune generator - Single pass stems export
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This tool render a tracker file once and write the mix and the post-gain signal of each channel (see render_stems())
+ * to WAV files (8 bits unsigned, SAMPLE_RATE) :
+ * - mix.wav : same samples as the sampling ISR
+ * - channel_N.wav : channel N after the ADSR envelope and the channel volume, before the mix
+ *   (the contribution of the channel to the mix is sample - 127, a muted channel is a constant)
+ *
+ * Usage : stems [output directory] [tracker file]\n
+ * Without tracker file the bundled tracker file is rendered (raw opcodes, like the songgen output, otherwise).\n
+ * Print one line per file : name, number of samples, lowest and highest sample of the channel.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Build with the linux port and STEM_OUTPUT defined (see README.md)
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+/* Includes */
+#include <stdint.h>          // For hardcoded type
+#include <stdio.h>           // For printf
+#include <stdlib.h>          // For malloc
+#include "../common.h"       // For common macro
+#include "../port.h"         // For platform dependent macro
+#include "../tracker.h"      // For tracker commands
+#include "../tracker_data.h" // For english note notation
+#include "../subtimer.h"     // For SubTimer structure
+#include "../envelope.h"     // For ADSR envelope name
+#include "../oscillator.h"   // For Waveform name
+#include "../mixer.h"        // For channel name
+#include "../modulation.h"   // For modulators
+#include "../voice.h"        // For voice pool
+#include "../render.h"       // For render session
+#include "../sink.h"         // For WAV sink
+
+#ifndef STEM_OUTPUT
+#error "stems need STEM_OUTPUT (build with -DSTEM_OUTPUT)"
+#endif
+
+/* Number of samples per render_stems() call */
+#define BLOCK_SIZE 4096
+
+/* Maximum size of a tracker file */
+#define MAX_SONG_LENGTH 65535
+
+/* Output files */
+static Sink_t mix_sink;
+static Sink_t stem_sinks[NUMBERS_OF_CHANNEL];
+
+/* Render buffers */
+static uint8_t mix_block[BLOCK_SIZE];
+static uint8_t stem_blocks[NUMBERS_OF_CHANNEL][BLOCK_SIZE];
+
+/* Lowest and highest sample of each channel */
+static uint8_t stem_lows[NUMBERS_OF_CHANNEL];
+static uint8_t stem_highs[NUMBERS_OF_CHANNEL];
+
+/* Load a tracker file, return its length (0 on error) */
+static uint16_t load_song(const char *filename, uint8_t *opcodes) {
+	FILE *file = fopen(filename, "rb");
+	if (!file) {
+		perror(filename);
+		return 0;
+	}
+	size_t length = fread(opcodes, 1, MAX_SONG_LENGTH, file);
+	fclose(file);
+	return length;
+}
+
+/* Open a WAV file of the output directory */
+static uint8_t open_wav(Sink_t *sink, const char *directory, const char *name) {
+	const Sink_format_t format = { SAMPLE_RATE, 1, 8 };
+	char filename[1024];
+	snprintf(filename, sizeof(filename), "%s/%s", directory, name);
+
+	if (!sink_open(sink, SINK_WAV, filename, &format)) {
+		perror(filename);
+		return 0;
+	}
+	return 1;
+}
+
+/* Program entry point */
+int main(int argc, char **argv) {
+	const char *directory = (argc > 1) ? argv[1] : ".";
+	static uint8_t opcodes[MAX_SONG_LENGTH];
+
+	/* Tracker file */
+	if (argc > 2) {
+		uint16_t length = load_song(argv[2], opcodes);
+		if (length == 0)
+			return 1;
+		tracker_load_song(opcodes, length);
+	}
+
+	/* Output files */
+	char name[32];
+	if (!open_wav(&mix_sink, directory, "mix.wav"))
+		return 1;
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		snprintf(name, sizeof(name), "channel_%u.wav", channel + 1);
+		if (!open_wav(&stem_sinks[channel], directory, name))
+			return 1;
+	}
+
+	/* Render the mix and the stems in one pass */
+	const Render_limits_t limits = { 0, 1 }; // Up to the first loop of the tracker file
+	Render_session_t session;
+	uint8_t *stems[NUMBERS_OF_CHANNEL];
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		stems[channel] = stem_blocks[channel];
+		stem_lows[channel] = 255;
+	}
+
+	render_start(&session, &limits);
+	while (session.status == RENDER_OK) {
+		uint32_t count = render_stems(&session, mix_block, stems, BLOCK_SIZE);
+		sink_write(&mix_sink, mix_block, count);
+		for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+			sink_write(&stem_sinks[channel], stem_blocks[channel], count);
+			for (uint32_t i = 0; i < count; ++i) {
+				if (stem_blocks[channel][i] < stem_lows[channel])
+					stem_lows[channel] = stem_blocks[channel][i];
+				if (stem_blocks[channel][i] > stem_highs[channel])
+					stem_highs[channel] = stem_blocks[channel][i];
+			}
+		}
+	}
+
+	/* Close output files */
+	uint8_t error = 0;
+	sink_close(&mix_sink);
+	error |= mix_sink.error;
+	printf("mix.wav : %lu samples\n", (unsigned long)mix_sink.length);
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		sink_close(&stem_sinks[channel]);
+		error |= stem_sinks[channel].error;
+		printf("channel_%u.wav : %lu samples, range %u - %u\n", channel + 1, (unsigned long)stem_sinks[channel].length,
+				stem_lows[channel], stem_highs[channel]);
+	}
+
+	if (error)
+		fprintf(stderr, "Unable to write output files\n");
+	return error ? 1 : 0;
+}
@@ -0,0 +1,292 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>          // For hardcoded type
+#include <string.h>          // For strcmp
+#include "../common.h"       // For common macro
+#include "../port.h"         // For platform dependent macro
+#include "../tracker.h"      // For tracker commands
+#include "../tracker_data.h" // For english note notation
+#include "../subtimer.h"     // For SubTimer structure
+#include "../envelope.h"     // For ADSR envelope name
+#include "../oscillator.h"   // For Waveform name
+#include "song_writer.h"     // For song writer structure
+#include "workload.h"        // For workload names
+
+/* Number of channels addressable by an opcode (channel is the low nibble of opcode) */
+#define CHANNELS ((NUMBERS_OF_CHANNEL < 16) ? NUMBERS_OF_CHANNEL : 16)
+
+/* Number of ADSR envelopes (ADSR_USER_1 to ADSR_USER_n, see adsr_envelopes) */
+#define ENVELOPES ADSR_ENVELOPES
+
+/* Legal ranges of arguments (see MS_TO_TICK and BPM_TO_TICK) */
+#define MIN_TEMPO 60
+#define MAX_TEMPO 65535
+#define MAX_ADSR_MS 1000
+
+/* Number of opcodes of the DIRECT_EXEC workload (maximum of DIRECT_EXEC) */
+#define DIRECT_EXEC_LENGTH 255
+
+const char *workload_names[WORKLOAD_COUNT] = { "noise", "note_storm", "direct_exec", "adsr_churn", "tempo", "mixed" };
+
+/* Random generator (xorshift) */
+static uint32_t random_state;
+
+static inline uint32_t next_random(void) {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+/* Random legal arguments */
+static inline uint8_t random_note(void) {
+	return NOTE_C2 + next_random() % 72;
+}
+
+static inline uint8_t random_waveform(void) {
+	return WF_SINUS + next_random() % 5;
+}
+
+static inline uint8_t random_envelope(void) {
+	return ADSR_USER_1 + next_random() % ENVELOPES;
+}
+
+static inline uint16_t random_ms(void) {
+	return 1 + next_random() % MAX_ADSR_MS;
+}
+
+static inline uint16_t random_tempo(void) {
+	return MIN_TEMPO + next_random() % (MAX_TEMPO - MIN_TEMPO + 1);
+}
+
+/* Write a SET_ADSR_VALUES opcode with random legal values */
+static void put_random_adsr_values(Song_writer_t *song) {
+	song_put_adsr_values(song, random_envelope(), random_ms(), random_ms(), next_random(), random_ms());
+}
+
+/* Write a note on */
+static void put_note_on(Song_writer_t *song, uint8_t channel) {
+	song_put_byte(song, NOTE_ON | channel);
+	song_put_byte(song, random_note());
+}
+
+/* Write a random legal opcode (except DIRECT_EXEC) */
+static void put_random_opcode(Song_writer_t *song, uint8_t channel) {
+	switch (next_random() % 13) {
+	case 0:
+		song_put_byte(song, NO_ACTION);
+		break;
+
+	case 1:
+		song_put_byte(song, SET_TEMPO);
+		song_put_word(song, random_tempo());
+		break;
+
+	case 2:
+		song_put_byte(song, SET_WAVE | channel);
+		song_put_byte(song, random_waveform());
+		break;
+
+	case 3:
+		song_put_byte(song, SET_VOLUME | channel);
+		song_put_byte(song, next_random());
+		break;
+
+	case 4:
+		song_put_byte(song, SET_GLOBAL_VOLUME);
+		song_put_byte(song, 128 + next_random() % 128);
+		break;
+
+	case 5:
+	case 6:
+		put_note_on(song, channel);
+		break;
+
+	case 7:
+		song_put_byte(song, NOTE_OFF | channel);
+		break;
+
+	case 8:
+		song_put_byte(song, SYNC_OSCILLATOR | channel);
+		song_put_byte(song, next_random() % CHANNELS);
+		break;
+
+	case 9:
+		song_put_byte(song, RESET_OSCILLATOR | channel);
+		break;
+
+	case 10:
+		song_put_byte(song, SET_ADSR | channel);
+		song_put_byte(song, random_envelope());
+		break;
+
+	case 11:
+		song_put_byte(song, SET_DUTY | channel);
+		song_put_byte(song, next_random());
+		break;
+
+	case 12:
+		/* SOFTWARE_RESET mute the mixer until the next SET_GLOBAL_VOLUME, keep it rare */
+		if (next_random() % 16 == 0)
+			song_put_byte(song, SOFTWARE_RESET);
+		else
+			put_random_adsr_values(song);
+		break;
+	}
+}
+
+/* Write setup of every channel (executed at startup) */
+static void put_setup(Song_writer_t *song, uint8_t workload) {
+	song_put_byte(song, DIRECT_EXEC);
+	song_put_byte(song, 2 + ENVELOPES + CHANNELS * 3);
+	song_put_byte(song, SET_TEMPO);
+	song_put_word(song, (workload == WORKLOAD_TEMPO || workload == WORKLOAD_DIRECT_EXEC) ? MAX_TEMPO : 600);
+	song_put_byte(song, SET_GLOBAL_VOLUME);
+	song_put_byte(song, 255);
+	for (uint8_t envelope = ADSR_USER_1; envelope < ADSR_USER_1 + ENVELOPES; ++envelope)
+		song_put_adsr_values(song, envelope, random_ms(), random_ms(), next_random(), random_ms());
+	for (uint8_t channel = 0; channel < CHANNELS; ++channel) {
+		song_put_byte(song, SET_WAVE | channel);
+		song_put_byte(song, (workload == WORKLOAD_NOISE) ? WF_NOISE : random_waveform());
+		song_put_byte(song, SET_VOLUME | channel);
+		song_put_byte(song, 255);
+		song_put_byte(song, SET_ADSR | channel);
+		song_put_byte(song, random_envelope());
+	}
+}
+
+/* Write one row (NUMBERS_OF_CHANNEL opcodes, or one DIRECT_EXEC which end the tick) */
+static void put_row(Song_writer_t *song, uint8_t workload, uint16_t row) {
+
+	/* One DIRECT_EXEC per tick */
+	if (workload == WORKLOAD_DIRECT_EXEC) {
+		song_put_byte(song, DIRECT_EXEC);
+		song_put_byte(song, DIRECT_EXEC_LENGTH);
+		for (uint8_t i = 0; i < DIRECT_EXEC_LENGTH; ++i) {
+			uint8_t channel = i % CHANNELS;
+			switch (i % 3) {
+			case 0:
+				put_note_on(song, channel);
+				break;
+
+			case 1:
+				song_put_byte(song, SET_ADSR | channel);
+				song_put_byte(song, random_envelope());
+				break;
+
+			case 2:
+				put_random_adsr_values(song);
+				break;
+			}
+		}
+		return;
+	}
+
+	/* One opcode per channel */
+	for (uint8_t channel = 0; channel < NUMBERS_OF_CHANNEL; ++channel) {
+		if (channel >= CHANNELS) {
+			song_put_byte(song, NO_ACTION);
+			continue;
+		}
+
+		switch (workload) {
+		case WORKLOAD_NOISE:
+			if ((row + channel) % 2 == 0)
+				put_note_on(song, channel);
+			else
+				song_put_byte(song, NO_ACTION);
+			break;
+
+		case WORKLOAD_NOTE_STORM:
+			put_note_on(song, channel);
+			break;
+
+		case WORKLOAD_ADSR_CHURN:
+			switch ((row + channel) % 3) {
+			case 0:
+				put_random_adsr_values(song);
+				break;
+
+			case 1:
+				song_put_byte(song, SET_ADSR | channel);
+				song_put_byte(song, random_envelope());
+				break;
+
+			case 2:
+				put_note_on(song, channel);
+				break;
+			}
+			break;
+
+		case WORKLOAD_TEMPO:
+			if (channel == 0) {
+				song_put_byte(song, SET_TEMPO);
+				song_put_word(song, random_tempo());
+			} else
+				put_note_on(song, channel);
+			break;
+
+		case WORKLOAD_MIXED:
+			/* A random DIRECT_EXEC end the row */
+			if (next_random() % 32 == 0) {
+				uint8_t count = 1 + next_random() % 32;
+				song_put_byte(song, DIRECT_EXEC);
+				song_put_byte(song, count);
+				for (uint8_t i = 0; i < count; ++i)
+					put_random_opcode(song, next_random() % CHANNELS);
+				return;
+			}
+			put_random_opcode(song, channel);
+			break;
+		}
+	}
+}
+
+uint8_t workload_find(const char *name) {
+	uint8_t workload;
+	for (workload = 0; workload < WORKLOAD_COUNT && strcmp(name, workload_names[workload]); ++workload)
+		;
+	return workload;
+}
+
+uint8_t workload_write(Song_writer_t *song, uint8_t workload, uint32_t seed, uint16_t rows) {
+	random_state = seed ? seed : 1; // xorshift state must not be 0
+	song->length = 0;
+	song->overflow = 0;
+	put_setup(song, workload);
+
+	/* Rows, stop before the first row which doesn't fit (keep room for the jump) */
+	uint16_t first_row = song->length;
+	for (uint16_t row = 0; row < rows; ++row) {
+		uint16_t row_start = song->length;
+		put_row(song, workload, row);
+		if (song->overflow || song->length > SONG_WRITER_MAX_LENGTH - 3) {
+			song->length = row_start;
+			song->overflow = 0;
+			break;
+		}
+	}
+	if (song->length == first_row)
+		return 0;
+
+	/* Loop forever */
+	song_put_byte(song, JUMP_IN_FILE);
+	song_put_word(song, first_row);
+	return 1;
+}
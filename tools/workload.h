@@ -0,0 +1,87 @@
+/**
+ * @file workload.h
+ * @brief Generic digital chiptune generator - Worst-case workload generator
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle write pathological but legal tracker files (see song_writer.h) for stress benchmarks :
+ * - Noise : every channel on WF_NOISE with ADSR, note on every 2 rows
+ * - Note storm : note on every channel every row
+ * - Direct exec : one DIRECT_EXEC of 255 heavy opcodes (note on, ADSR changes) every tick, at the fastest tempo
+ * - ADSR churn : SET_ADSR_VALUES, SET_ADSR and note on on every channel every row
+ * - Tempo : tempo change every row (up to the fastest tempo), note on every channel
+ * - Mixed : random legal opcodes with random legal arguments
+ *
+ * Legal means : channels and ADSR envelopes in range, ADSR times from 1 to 1000ms, tempo from 60 to 65535 BPM
+ * (MS_TO_TICK and BPM_TO_TICK divide by zero outside of these ranges), no nested DIRECT_EXEC and no END_OF_STREAM.\n
+ * Every tracker file loop forever with a JUMP_IN_FILE to its first row.\n
+ * Random notes, waveforms and arguments are drawn from a xorshift generator, the same seed always write the same tracker file.\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _WORKLOAD_H_
+#define _WORKLOAD_H_
+
+/**
+ * Workloads
+ */
+typedef enum {
+	WORKLOAD_NOISE,
+	WORKLOAD_NOTE_STORM,
+	WORKLOAD_DIRECT_EXEC,
+	WORKLOAD_ADSR_CHURN,
+	WORKLOAD_TEMPO,
+	WORKLOAD_MIXED,
+	WORKLOAD_COUNT
+} Workload_t;
+
+/**
+ * Default number of rows of a workload
+ */
+#define WORKLOAD_DEFAULT_ROWS 64
+
+/**
+ * Workload names (indexed by Workload_t)
+ */
+extern const char *workload_names[WORKLOAD_COUNT];
+
+/**
+ * Find a workload by name
+ *
+ * @param name Workload name
+ * @return Workload, WORKLOAD_COUNT if unknown
+ */
+uint8_t workload_find(const char *name);
+
+/**
+ * Write a workload tracker file
+ *
+ * @param song Pointer to a Song_writer_t object (previous content is discarded)
+ * @param workload Workload to write
+ * @param seed Seed of random generator
+ * @param rows Number of rows before the jump to the first row
+ * @return 1 on success, 0 if the tracker file is too long (see SONG_WRITER_MAX_LENGTH)
+ */
+uint8_t workload_write(Song_writer_t *song, uint8_t workload, uint32_t seed, uint16_t rows);
+
+#endif // _WORKLOAD_H_
@@ -25,9 +25,13 @@
 #include "envelope.h"     // For ADSR envelope name
 #include "oscillator.h"   // For Waveform name
 #include "mixer.h"        // For channel name
+#include "profile.h"      // For cycle counter
+#include "deadline.h"     // For deadline monitor
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool
 
 /* Frequency lookup table @8KHz */
-static const uint8_t frequency_table[128] PROGMEM = { 0, 0, 0, 0, 0, 0, 0, 0,
+const uint8_t frequency_table[128] PROGMEM = { 0, 0, 0, 0, 0, 0, 0, 0,
 		0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
 		2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 5, 5, 5, 6, 6, 6,
 		7, 7, 7, 8, 8, 9, 9, 10, 11, 11, 12, 13, 13, 14, 15, 16, 17, 18, 19,
@@ -36,64 +40,230 @@ static const uint8_t frequency_table[128] PROGMEM = { 0, 0, 0, 0, 0, 0, 0, 0,
 		142, 150, 159, 169, 179, 189, 201, 213, 225, 239, 253, 0, 0, 0, 0, 0,
 		0, 0, 0 };
 
+/* Channel commands : logical channels of the voice pool, or mixer channels */
+#ifdef VOICE_POOL
+#define CHANNEL_COMMAND(name) voice_##name
+#else
+#define CHANNEL_COMMAND(name) mixer_##name
+#endif
+
+/* Modulators commands : logical channels of the voice pool, or mixer channels */
+#ifdef VOICE_POOL
+#define MODULATION_COMMAND(name) voice_##name
+#else
+#define MODULATION_COMMAND(name) modulation_##name
+#endif
+
+/* Mask of channel bytes (extended opcodes, SYNC_OSCILLATOR target), channels above 15 need the whole byte */
+#if defined(VOICE_POOL) || NUMBERS_OF_CHANNEL > 16
+#define CHANNEL_BYTE_MASK 0xFF
+#else
+#define CHANNEL_BYTE_MASK 0x0F
+#endif
+
 /* Tempo timer */
-volatile SubTimer_t tempo_timer = { BPM_TO_TICK(300), 0 };
+volatile SubTimer_t tempo_timer = { BPM_TO_TICK(TRACKER_DEFAULT_TEMPO), 0 };
 
 /* Tracker file index */
 uint16_t tracker_index = 0;
 
+/* End of stream flag */
+uint8_t tracker_end_of_stream = 0;
+
+/* Loop counter */
+uint16_t tracker_loop_count = 0;
+
+/* Opcodes left in direct exec groups */
+uint16_t tracker_pending = 0;
+
+/* Deferral counters */
+uint32_t tracker_deferrals = 0;
+uint16_t tracker_max_pending = 0;
+
+#ifdef RENDER_API
+/* Tracker file read trace */
+uint16_t tracker_trace_low = 0xFFFF;
+uint16_t tracker_trace_high = 0;
+
+/* Tracker file loaded from memory (NULL for tracker_music_opcodes) */
+static const uint8_t *song_opcodes = NULL;
+static uint16_t song_length = 0;
+
+/* Add a range of address to the tracker file read trace */
+static inline void trace_fetch(uint16_t first, uint16_t last) {
+	if (first < tracker_trace_low)
+		tracker_trace_low = first;
+	if (last > tracker_trace_high)
+		tracker_trace_high = last;
+}
+#endif
+
+/* Fetch a byte from tracker file */
+static inline uint8_t fetch_byte(uint16_t address) {
+#ifdef RENDER_API
+	trace_fetch(address, address);
+	if (song_opcodes)
+		return song_opcodes[address];
+#endif
+	return get_byte_from_tracker(address);
+}
+
+/* Fetch a word from tracker file */
+static inline uint16_t fetch_word(uint16_t address) {
+#ifdef RENDER_API
+	trace_fetch(address, address + 1);
+	if (song_opcodes)
+		return ((uint16_t)song_opcodes[address] << 8) | song_opcodes[address + 1];
+#endif
+	return get_word_from_tracker(address);
+}
+
+#ifdef RENDER_API
+void tracker_load_song(const uint8_t *opcodes, uint16_t length) {
+	song_opcodes = opcodes;
+	song_length = length;
+}
+#endif
+
 /* Reset tracker */
 void reset_tracker(void) {
 	tracker_index = 0;
-	subtimer_reset(&tempo_timer, 0);
+	subtimer_set_compare(&tempo_timer, BPM_TO_TICK(TRACKER_DEFAULT_TEMPO));
+	tracker_end_of_stream = 0;
+	tracker_loop_count = 0;
+	tracker_pending = 0;
+	tracker_deferrals = 0;
+	tracker_max_pending = 0;
 }
 
-uint8_t tracker_fetch_execute(void) {
+/* Fetch and execute one opcode (DIRECT_EXEC only add its instructions to tracker_pending) */
+static uint8_t execute_opcode(void) {
 	/* Fetch an byte from music file */
-	uint8_t command = get_byte_from_tracker(tracker_index++);
+	uint8_t command = fetch_byte(tracker_index++);
 	uint8_t channel = command & 0x0F;
 
+	/* Channel prefix : channel of the next opcode is the next byte */
+	if (command == CHANNEL_PREFIX) {
+		channel = fetch_byte(tracker_index++);
+		command = fetch_byte(tracker_index++);
+	}
+	deadline_opcode(command);
+
 	/* Interpret opcode */
 	switch (command & 0xF0) {
-	case NO_ACTION: // No action
+	case NO_ACTION: // No action, or extended opcode
+		switch (command) {
+		case SET_PAN: // Set channel position on the output bus <channel 1 byte> <pan 1 byte>
+			channel = fetch_byte(tracker_index++) & CHANNEL_BYTE_MASK;
+			CHANNEL_COMMAND(set_pan)(channel, fetch_byte(tracker_index++));
+			break;
+
+		case SET_VOICES: // Set number of voices of the voice pool <voices 1 byte>
+#ifdef VOICE_POOL
+			voice_set_pool_size(fetch_byte(tracker_index));
+#endif
+			++tracker_index;
+			break;
+
+		case SET_INSTRUMENT: // Set channel instrument <channel 1 byte> <instrument 1 byte>
+#ifdef INSTRUMENT_BANK
+			channel = fetch_byte(tracker_index) & CHANNEL_BYTE_MASK;
+			CHANNEL_COMMAND(set_instrument)(channel, fetch_byte(tracker_index + 1));
+#endif
+			tracker_index += 2;
+			break;
+
+		case SET_INSTRUMENT_VALUES: // Set instrument <instrument 1 byte> <waveform 1 byte> <duty 1 byte> <volume 1 byte> <ADSR type 1 byte>
+#ifdef INSTRUMENT_BANK
+			setup_instrument(fetch_byte(tracker_index), fetch_byte(tracker_index + 1), fetch_byte(tracker_index + 2),
+					fetch_byte(tracker_index + 3), fetch_byte(tracker_index + 4));
+#endif
+			tracker_index += 5;
+			break;
+
+		case SET_VIBRATO: // Set channel vibrato <channel 1 byte> <depth 1 byte> <speed 1 byte>
+#ifdef MODULATION
+			channel = fetch_byte(tracker_index) & CHANNEL_BYTE_MASK;
+			MODULATION_COMMAND(set_vibrato)(channel, fetch_byte(tracker_index + 1), fetch_byte(tracker_index + 2));
+#endif
+			tracker_index += 3;
+			break;
+
+		case SET_ARPEGGIO: // Set channel arpeggio <channel 1 byte> <semitones 1 byte> <updates per step 1 byte>
+#ifdef MODULATION
+			channel = fetch_byte(tracker_index) & CHANNEL_BYTE_MASK;
+			MODULATION_COMMAND(set_arpeggio)(channel, fetch_byte(tracker_index + 1), fetch_byte(tracker_index + 2));
+#endif
+			tracker_index += 3;
+			break;
+
+		case SET_PORTAMENTO: // Set channel portamento <channel 1 byte> <speed 1 byte>
+#ifdef MODULATION
+			channel = fetch_byte(tracker_index) & CHANNEL_BYTE_MASK;
+			MODULATION_COMMAND(set_portamento)(channel, fetch_byte(tracker_index + 1));
+#endif
+			tracker_index += 2;
+			break;
+
+		case SET_PWM: // Set channel duty LFO <channel 1 byte> <depth 1 byte> <speed 1 byte>
+#ifdef MODULATION
+			channel = fetch_byte(tracker_index) & CHANNEL_BYTE_MASK;
+			MODULATION_COMMAND(set_pwm)(channel, fetch_byte(tracker_index + 1), fetch_byte(tracker_index + 2));
+#endif
+			tracker_index += 3;
+			break;
+
+		case SET_VOLUME_SLIDE: // Set channel volume slide <channel 1 byte> <signed step 1 byte>
+#ifdef MODULATION
+			channel = fetch_byte(tracker_index) & CHANNEL_BYTE_MASK;
+			MODULATION_COMMAND(set_volume_slide)(channel, (int8_t)fetch_byte(tracker_index + 1));
+#endif
+			tracker_index += 2;
+			break;
+		}
 		break;
 
 	case SET_TEMPO: // Set tempo <tempo 2 bytes>
 		subtimer_set_compare(
 				&tempo_timer,
-				BPM_TO_TICK(get_word_from_tracker(tracker_index)));
+				BPM_TO_TICK(fetch_word(tracker_index)));
 		tracker_index += 2;
 		break;
 
 	case SET_WAVE: // Set waveform <waveform 1 byte>
-		mixer_set_wave(channel, get_byte_from_tracker(tracker_index++));
+		CHANNEL_COMMAND(set_wave)(channel, fetch_byte(tracker_index++));
 		break;
 
 	case SET_VOLUME: // Set channel volume <volume 1 byte>
-		mixer_set_volume(channel, get_byte_from_tracker(tracker_index++));
+		CHANNEL_COMMAND(set_volume)(channel, fetch_byte(tracker_index++));
 		break;
 
 	case SET_GLOBAL_VOLUME: // Set global volume <volume 1 byte>
-		mixer_set_global_volume(get_byte_from_tracker(tracker_index++));
+		mixer_set_global_volume(fetch_byte(tracker_index++));
 		break;
 
 	case NOTE_ON: // Note on <note 1 byte>
-		command = get_byte_from_tracker(tracker_index++) & 127;
-		mixer_note_on(channel, pgm_read_byte(frequency_table + command));
+		command = fetch_byte(tracker_index++) & 127;
+		CHANNEL_COMMAND(note_on)(channel, pgm_read_byte(frequency_table + command));
+#ifdef MODULATION
+		MODULATION_COMMAND(set_note)(channel, command);
+#endif
 		break;
 
 	case NOTE_OFF: // Note off
-		mixer_note_off(channel);
+		CHANNEL_COMMAND(note_off)(channel);
 		break;
 
 	case END_OF_STREAM: // End of tracker file
-		stop_timer_dac();
+		tracker_end_of_stream = 1;
+		tracker_pending = 0;
 #ifndef EMULATE_TIMER
+		stop_timer_dac();
 		for (;;)
 			;
 #else
-		puts("END OF STREAM\n");
-		exit(0);
+		--tracker_index; // Stay on END_OF_STREAM, caller stop rendering
+		return 1;
 #endif
 		break;
 
@@ -102,42 +272,47 @@ uint8_t tracker_fetch_execute(void) {
 		break;
 
 	case SYNC_OSCILLATOR: // Sync channel oscillator <target 1 byte>
-		mixer_sync_oscillators(channel, get_byte_from_tracker(tracker_index++) & 0x0F);
+		CHANNEL_COMMAND(sync_oscillators)(channel, fetch_byte(tracker_index++) & CHANNEL_BYTE_MASK);
 		break;
 
 	case RESET_OSCILLATOR: // Reset oscillator phase to the start point
-		mixer_reset_oscillator(channel);
+		CHANNEL_COMMAND(reset_oscillator)(channel);
 		break;
 
 	case SET_ADSR: // Set ADSR envelope of channel <ADSR type 1 byte>
-		mixer_set_adsr(channel, get_byte_from_tracker(tracker_index++));
+		CHANNEL_COMMAND(set_adsr)(channel, fetch_byte(tracker_index++));
 		break;
 
 	case JUMP_IN_FILE: // Jump somewhere in the tracker file <target 2 bytes>
-		tracker_index = get_word_from_tracker(tracker_index);
+	{
+		uint16_t target = fetch_word(tracker_index);
+		if (target < tracker_index)
+			++tracker_loop_count; // Backward jump
+		tracker_index = target;
+	}
 		break;
 
 	case SET_DUTY: // Set square wave duty <duty 1 byte>
-		mixer_set_duty(channel, get_byte_from_tracker(tracker_index++));
+		CHANNEL_COMMAND(set_duty)(channel, fetch_byte(tracker_index++));
 		break;
 
 	case DIRECT_EXEC: // Execute n instructions in one step <instruction_count 1 byte>
-		// Re-use command variable to store instruction count to execute
-		command = get_byte_from_tracker( tracker_index++);
-		for (uint8_t i = 0; i < command; ++i) {
-			tracker_fetch_execute();
-		}
+		// Nested groups are flattened : same order of execution, no recursion
+		command = fetch_byte(tracker_index++);
+		tracker_pending = (tracker_pending > 0xFFFF - command) ? 0xFFFF : tracker_pending + command;
+		if (tracker_pending > tracker_max_pending)
+			tracker_max_pending = tracker_pending;
 		return 1;
 		break;
 
 	case SET_ADSR_VALUES: // Set ADSR envelope <Attack in ms 2 bytes> <Decay in ms 2 bytes> <Sustain volume 1 bytes> <Release in ms 2 bytes>
 	{
-		uint16_t attack = get_word_from_tracker(tracker_index);
+		uint16_t attack = fetch_word(tracker_index);
 		tracker_index += 2;
-		uint16_t decay = get_word_from_tracker(tracker_index);
+		uint16_t decay = fetch_word(tracker_index);
 		tracker_index += 2;
-		uint8_t sustain_level = get_byte_from_tracker(tracker_index++);
-		uint16_t release = get_word_from_tracker(tracker_index);
+		uint8_t sustain_level = fetch_byte(tracker_index++);
+		uint16_t release = fetch_word(tracker_index);
 		tracker_index += 2;
 		setup_adsr_envelope(channel, attack, decay, sustain_level, release);
 	}
@@ -146,17 +321,52 @@ uint8_t tracker_fetch_execute(void) {
 	return 0;
 }
 
+/* Execute opcodes of direct exec groups, up to budget (leftover opcodes are deferred to next tick) */
+static void execute_pending(uint16_t budget) {
+	while (tracker_pending) {
+		if (budget == 0) {
+			++tracker_deferrals;
+			return;
+		}
+		--budget;
+		--tracker_pending;
+		execute_opcode();
+	}
+}
+
+uint8_t tracker_fetch_execute(void) {
+	uint8_t end_of_tick = execute_opcode();
+	execute_pending(TRACKER_TICK_BUDGET - 1);
+	return end_of_tick;
+}
+
 void tracker_tempo_tick(void) {
 	if (subtimer_tick(&tempo_timer)) {
 
 		/* Handle endless tracker file */
-		if (tracker_index >= tracker_music_length)
+#ifdef RENDER_API
+		if (tracker_index >= (song_opcodes ? song_length : tracker_music_length)) {
+#else
+		if (tracker_index >= tracker_music_length) {
+#endif
 			tracker_index = 0;
+			++tracker_loop_count;
+		}
+
+		/* Deferred opcodes of a direct exec group end the tick */
+		if (tracker_pending) {
+			execute_pending(TRACKER_TICK_BUDGET);
+			return;
+		}
 
 		/* For each channels of mixer */
+		uint16_t budget = TRACKER_TICK_BUDGET;
 		for (uint8_t i = 0; i < NUMBERS_OF_CHANNEL; ++i) {
-			if (tracker_fetch_execute())
+			--budget;
+			if (execute_opcode()) {
+				execute_pending(budget);
 				break;
+			}
 		}
 	}
 }
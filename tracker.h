@@ -35,7 +35,7 @@
  * Tracker opcodes
  */
 typedef enum {
-	NO_ACTION = 0x00, // No action
+	NO_ACTION = 0x00, // No action (0x01 - 0x0F : extended opcodes, see below)
 	SET_TEMPO = 0x10, // Set tempo <tempo 2 bytes>
 	SET_WAVE = 0x20, // Set waveform <waveform 1 byte>
 	SET_VOLUME = 0x30, // Set channel volume <volume 1 byte>
@@ -52,8 +52,88 @@ typedef enum {
 	DIRECT_EXEC = 0xE0, // Execute n instructions in one step <instruction_count 1 byte>
 	SET_ADSR_VALUES = 0xF0
 // Set ADSR envelope <Attack in ms 2 bytes> <Decay in ms 2 bytes> <Sustain volume 1 bytes> <Release in ms 2 bytes>
+// The low nibble is the envelope (ADSR_USER_1 to ADSR_USER_15), ADSR_USER_16 is set with CHANNEL_PREFIX <16> <SET_ADSR_VALUES> ...
 } Tracker_opcode;
 
+/**
+ * Extended tracker opcodes (NO_ACTION group, the low nibble is the extended opcode, the channel is the next byte, its low nibble only up to 16 channels without VOICE_POOL)
+ */
+typedef enum {
+	SET_PAN = 0x01, // Set channel position on the output bus <channel 1 byte> <pan 1 byte> (0 = first output, 128 = center, 255 = last output)
+	CHANNEL_PREFIX = 0x02, // Channel of the next opcode (channels above 15) <channel 1 byte> <opcode>
+	SET_VOICES = 0x03, // Set number of voices of the voice pool <voices 1 byte> (ignored without VOICE_POOL)
+	SET_INSTRUMENT = 0x04, // Set waveform, duty, volume and ADSR envelope of channel from an instrument <channel 1 byte> <instrument 1 byte> (ignored without INSTRUMENT_BANK)
+	SET_INSTRUMENT_VALUES = 0x05, // Set instrument <instrument 1 byte> <waveform 1 byte> <duty 1 byte> <volume 1 byte> <ADSR type 1 byte> (ignored without INSTRUMENT_BANK)
+	SET_VIBRATO = 0x06, // Set channel vibrato <channel 1 byte> <depth 1 byte> <speed 1 byte> (ignored without MODULATION, see modulation.h)
+	SET_ARPEGGIO = 0x07, // Set channel arpeggio <channel 1 byte> <semitones 1 byte, 2 nibbles> <updates per step 1 byte> (ignored without MODULATION)
+	SET_PORTAMENTO = 0x08, // Set channel portamento <channel 1 byte> <speed 1 byte> (ignored without MODULATION)
+	SET_PWM = 0x09, // Set channel duty LFO <channel 1 byte> <depth 1 byte> <speed 1 byte> (ignored without MODULATION)
+	SET_VOLUME_SLIDE = 0x0A // Set channel volume slide <channel 1 byte> <signed step 1 byte> (ignored without MODULATION)
+} Tracker_extended_opcode;
+
+/**
+ * Frequency lookup table @8KHz (tuning word of each note)
+ */
+extern const uint8_t frequency_table[128] PROGMEM;
+
+/**
+ * Default tempo of tracker (in BPM)
+ */
+#define TRACKER_DEFAULT_TEMPO 300
+
+/**
+ * Tracker file index
+ */
+extern uint16_t tracker_index;
+
+/**
+ * End of stream flag (set by END_OF_STREAM opcode)
+ */
+extern uint8_t tracker_end_of_stream;
+
+/**
+ * Number of loops of tracker file (end of file reached or backward JUMP_IN_FILE)
+ */
+extern uint16_t tracker_loop_count;
+
+/**
+ * Number of opcodes left in direct exec groups (deferred to next tick when the tick budget is spent)
+ */
+extern uint16_t tracker_pending;
+
+/**
+ * Number of ticks which deferred opcodes, and largest number of opcodes left in direct exec groups
+ */
+extern uint32_t tracker_deferrals;
+extern uint16_t tracker_max_pending;
+
+#ifdef RENDER_API
+/**
+ * Lowest and highest tracker file address read since last call of tracker_trace_reset()
+ *
+ * @remarks tracker_trace_low > tracker_trace_high if nothing was read
+ */
+extern uint16_t tracker_trace_low;
+extern uint16_t tracker_trace_high;
+
+/**
+ * Reset tracker file read trace
+ */
+inline void tracker_trace_reset(void) {
+	tracker_trace_low = 0xFFFF;
+	tracker_trace_high = 0;
+}
+
+/**
+ * Play a tracker file from memory instead of tracker_music_opcodes
+ *
+ * @param opcodes Pointer to tracker file (NULL to restore tracker_music_opcodes)
+ * @param length Length of tracker file
+ * @remarks Words are stored high byte first (like the computer port)
+ */
+void tracker_load_song(const uint8_t *opcodes, uint16_t length);
+#endif
+
 /**
  * Reset tracker
  */
@@ -63,11 +143,14 @@ void reset_tracker(void);
  * Fetch and execute opcode
  *
  * @return 1 if no more events have to be processed for this timer event, 0 otherwise
+ * @remarks A DIRECT_EXEC execute its instructions (and nested groups) up to TRACKER_TICK_BUDGET opcodes, leftover opcodes are executed by next ticks
  */
 uint8_t tracker_fetch_execute(void);
 
 /**
  * Tracker tempo tick
+ *
+ * @remarks Execute at most TRACKER_TICK_BUDGET opcodes, deferred opcodes of a direct exec group are executed first and end the tick
  */
 void tracker_tempo_tick(void);
 
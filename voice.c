@@ -0,0 +1,304 @@
+/*
+ * See header file for details
+ *
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ *
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ *
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ */
+
+/* Includes */
+#include <stdint.h>       // For hardcoded type
+#include "common.h"       // For common macro
+#include "port.h"         // For platform dependent macro
+#include "tracker.h"      // For tracker commands
+#include "tracker_data.h" // For english note notation
+#include "subtimer.h"     // For SubTimer structure
+#include "envelope.h"     // For ADSR envelope name
+#include "oscillator.h"   // For Waveform name
+#include "mixer.h"        // For channel name
+#include "modulation.h"   // For modulators
+#include "voice.h"        // For voice pool structure
+#include "profile.h"      // For cycle counter
+#include "quality.h"      // For muted voices
+
+#ifdef VOICE_POOL
+
+/* Voice pool */
+volatile Voice_pool_t voice_pool;
+
+void voice_reset(void) {
+	for (uint8_t channel = 0; channel < VOICE_LOGICAL_CHANNELS; ++channel) {
+		volatile Logical_channel_t *logical = &(voice_pool.channels[channel]);
+		logical->voice = VOICE_NONE;
+		logical->waveform = WF_NONE;
+		logical->duty = 127;
+		logical->volume = 0;
+		logical->envelope = ADSR_NONE;
+		logical->pan = 128;
+#ifdef MODULATION
+		logical->modulation.vibrato_depth = 0;
+		logical->modulation.vibrato_speed = 0;
+		logical->modulation.arpeggio = 0;
+		logical->modulation.arpeggio_speed = 0;
+		logical->modulation.portamento = 0;
+		logical->modulation.pwm_depth = 0;
+		logical->modulation.pwm_speed = 0;
+		logical->modulation.volume_slide = 0;
+#endif
+	}
+	for (uint8_t voice = 0; voice < NUMBERS_OF_CHANNEL; ++voice) {
+		voice_pool.owners[voice] = VOICE_NONE;
+		voice_pool.released[voice] = 0;
+		voice_pool.stamps[voice] = 0;
+	}
+	voice_pool.notes = 0;
+	voice_pool.size = NUMBERS_OF_CHANNEL;
+	voice_pool.steals = 0;
+}
+
+/* Detach a voice from its logical channel */
+static inline void detach_voice(uint8_t voice) {
+	uint8_t owner = voice_pool.owners[voice];
+	if (owner != VOICE_NONE)
+		voice_pool.channels[owner].voice = VOICE_NONE;
+	voice_pool.owners[voice] = VOICE_NONE;
+	voice_pool.released[voice] = 0;
+}
+
+void voice_set_pool_size(uint8_t size) {
+	if (size == 0)
+		size = 1;
+	if (size > NUMBERS_OF_CHANNEL)
+		size = NUMBERS_OF_CHANNEL;
+
+	/* Cut notes of removed voices (not rendered any more, silent when the pool grow again) */
+	for (uint8_t voice = size; voice < voice_pool.size; ++voice) {
+		detach_voice(voice);
+		mixer_set_volume(voice, 0);
+	}
+	voice_pool.size = size;
+}
+
+/* Steal priority of a voice (the greatest is stolen) : released notes first, then oldest note or quietest voice */
+static inline uint32_t steal_priority(uint8_t voice) {
+	uint32_t priority = (uint32_t)voice_pool.released[voice] << 16;
+#ifdef VOICE_STEAL_QUIETEST
+	volatile Envelope_t *envelope = &(mixer.channels[voice].envelope);
+	uint8_t level = (envelope->type == ADSR_NONE) ? 255 : (envelope->ended ? 0 : envelope->value);
+	return priority + 0xFFFF - (uint16_t)level * mixer.channels[voice].volume;
+#else
+	return priority + (uint16_t)(voice_pool.notes - voice_pool.stamps[voice]);
+#endif
+}
+
+/* Find a free voice, or the voice to steal (voices muted by adaptive quality are skipped) */
+static uint8_t allocate_voice(void) {
+	uint8_t victim = VOICE_NONE;
+	uint32_t victim_priority = 0;
+
+	for (uint8_t voice = 0; voice < voice_pool.size; ++voice) {
+		if (quality_voice_dropped(voice)) // Note would be silent
+			continue;
+		if (voice_pool.owners[voice] == VOICE_NONE
+				|| (voice_pool.released[voice] && mixer.channels[voice].envelope.ended))
+			return voice;
+		uint32_t priority = steal_priority(voice);
+		if (priority >= victim_priority) {
+			victim = voice;
+			victim_priority = priority;
+		}
+	}
+
+	/* Every voice of the pool is muted (pool shrunk after drops) : unmute the first one */
+	if (victim == VOICE_NONE) {
+		quality_restore_voice(0);
+		return allocate_voice();
+	}
+	++(voice_pool.steals);
+	return victim;
+}
+
+void voice_set_wave(uint8_t channel, uint8_t waveform) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].waveform = waveform;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		mixer_set_wave(voice, waveform);
+}
+
+void voice_set_volume(uint8_t channel, uint8_t volume) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].volume = volume;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		mixer_set_volume(voice, volume);
+}
+
+void voice_set_pan(uint8_t channel, uint8_t pan) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].pan = pan;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		mixer_set_pan(voice, pan);
+}
+
+void voice_set_adsr(uint8_t channel, uint8_t envelope) {
+	if (channel >= VOICE_LOGICAL_CHANNELS || envelope > ADSR_ENVELOPES)
+		return;
+	voice_pool.channels[channel].envelope = envelope;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		mixer_set_adsr(voice, envelope);
+}
+
+void voice_set_duty(uint8_t channel, uint8_t duty) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].duty = duty;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		mixer_set_duty(voice, duty);
+}
+
+#ifdef INSTRUMENT_BANK
+void voice_set_instrument(uint8_t channel, uint8_t instrument) {
+	if (channel >= VOICE_LOGICAL_CHANNELS || instrument >= INSTRUMENTS)
+		return;
+	volatile Logical_channel_t *logical = &(voice_pool.channels[channel]);
+	logical->waveform = instruments[instrument].waveform;
+	logical->duty = instruments[instrument].duty;
+	logical->volume = instruments[instrument].volume;
+	logical->envelope = instruments[instrument].envelope;
+	if (logical->voice != VOICE_NONE)
+		mixer_set_instrument(logical->voice, instrument);
+}
+#endif
+
+#ifdef MODULATION
+void voice_set_note(uint8_t channel, uint8_t note) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		modulation_set_note(voice, note);
+}
+
+void voice_set_vibrato(uint8_t channel, uint8_t depth, uint8_t speed) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].modulation.vibrato_depth = depth;
+	voice_pool.channels[channel].modulation.vibrato_speed = speed;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		modulation_set_vibrato(voice, depth, speed);
+}
+
+void voice_set_arpeggio(uint8_t channel, uint8_t semitones, uint8_t speed) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].modulation.arpeggio = semitones;
+	voice_pool.channels[channel].modulation.arpeggio_speed = speed;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		modulation_set_arpeggio(voice, semitones, speed);
+}
+
+void voice_set_portamento(uint8_t channel, uint8_t speed) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].modulation.portamento = speed;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		modulation_set_portamento(voice, speed);
+}
+
+void voice_set_pwm(uint8_t channel, uint8_t depth, uint8_t speed) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].modulation.pwm_depth = depth;
+	voice_pool.channels[channel].modulation.pwm_speed = speed;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		modulation_set_pwm(voice, depth, speed);
+}
+
+void voice_set_volume_slide(uint8_t channel, int8_t slide) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	voice_pool.channels[channel].modulation.volume_slide = slide;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		modulation_set_volume_slide(voice, slide);
+}
+#endif
+
+void voice_note_on(uint8_t channel, uint8_t frequency) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	volatile Logical_channel_t *logical = &(voice_pool.channels[channel]);
+	uint8_t voice = logical->voice;
+
+	/* Allocate a voice, apply the settings of the logical channel */
+	if (voice == VOICE_NONE) {
+		voice = allocate_voice();
+		detach_voice(voice);
+		voice_pool.owners[voice] = channel;
+		logical->voice = voice;
+		mixer_set_wave(voice, logical->waveform);
+		mixer_set_duty(voice, logical->duty);
+		mixer_set_volume(voice, logical->volume);
+		mixer_set_pan(voice, logical->pan);
+		mixer_set_adsr(voice, logical->envelope);
+#ifdef MODULATION
+		modulation_apply_settings(voice, &(logical->modulation));
+#endif
+	}
+
+	voice_pool.released[voice] = 0;
+	voice_pool.stamps[voice] = voice_pool.notes++;
+	mixer_note_on(voice, frequency);
+}
+
+void voice_note_off(uint8_t channel) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice == VOICE_NONE)
+		return;
+	mixer_note_off(voice);
+	if (mixer.channels[voice].envelope.type == ADSR_NONE)
+		detach_voice(voice); // Note cut at once
+	else
+		voice_pool.released[voice] = 1;
+}
+
+void voice_sync_oscillators(uint8_t channel_1, uint8_t channel_2) {
+	if (channel_1 >= VOICE_LOGICAL_CHANNELS || channel_2 >= VOICE_LOGICAL_CHANNELS)
+		return;
+	uint8_t voice_1 = voice_pool.channels[channel_1].voice;
+	uint8_t voice_2 = voice_pool.channels[channel_2].voice;
+	if (voice_1 != VOICE_NONE && voice_2 != VOICE_NONE)
+		mixer_sync_oscillators(voice_1, voice_2);
+}
+
+void voice_reset_oscillator(uint8_t channel) {
+	if (channel >= VOICE_LOGICAL_CHANNELS)
+		return;
+	uint8_t voice = voice_pool.channels[channel].voice;
+	if (voice != VOICE_NONE)
+		mixer_reset_oscillator(voice);
+}
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file voice.h
+ * @brief Generic digital chiptune generator - Voice pool
+ * @author SkyWodd
+ * @version 1.0
+ * @see http://skyduino.wordpress.com/
+ *
+ * @section intro_sec Introduction
+ * This functions bundle map the logical channels of the tracker file (VOICE_LOGICAL_CHANNELS channels)
+ * onto the mixer channels (voices), a voice is allocated to a logical channel at each note on.\n
+ * Each logical channel keep its own settings (waveform, duty, volume, ADSR envelope type and pan, or an instrument, and modulators with MODULATION),
+ * they are applied to its voice when it is allocated, and forwarded to its voice while it plays.\n
+ * A voice is free when it has no logical channel, or when its note is released and its envelope has ended
+ * (a note off without ADSR envelope free the voice at once).
+ * When no voice is free, a voice is stolen : released voices first, then the oldest note
+ * (or the quietest voice, envelope x volume, with VOICE_STEAL_QUIETEST), the logical channel which lose it is silent until its next note on.\n
+ * The pool is a static array of NUMBERS_OF_CHANNEL voices (no dynamic allocation on MCU),
+ * its size can be reduced at runtime by the SET_VOICES extended opcode : voices above the pool size are neither allocated nor rendered.\n
+ * Logical channels above 15 are addressed by the CHANNEL_PREFIX extended opcode (see tracker.h).\n
+ * \n
+ * Please report bug to <skywodd at gmail.com>
+ * @remarks Define VOICE_POOL in common.h to use this functions bundle, include mixer.h and modulation.h before this file
+ *
+ * @section licence_sec Licence
+ *  This program is free software: you can redistribute it and/or modify\n
+ *  it under the terms of the GNU General Public License as published by\n
+ *  the Free Software Foundation, either version 3 of the License, or\n
+ *  (at your option) any later version.\n
+ * \n
+ *  This program is distributed in the hope that it will be useful,\n
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of\n
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n
+ *  GNU General Public License for more details.\n
+ * \n
+ *  You should have received a copy of the GNU General Public License\n
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.\n
+ *
+ * @section changelog_sec Changelog history
+ * - 19/10/2026 : First version
+ */
+
+#ifndef _VOICE_H_
+#define _VOICE_H_
+
+#ifdef VOICE_POOL
+
+/**
+ * No voice / no logical channel
+ */
+#define VOICE_NONE 0xFF
+
+/**
+ * Logical channel structure
+ */
+typedef struct {
+	uint8_t voice;    // Voice playing this channel (VOICE_NONE if none)
+	uint8_t waveform;
+	uint8_t duty;
+	uint8_t volume;
+	uint8_t envelope; // ADSR envelope type
+	uint8_t pan;
+#ifdef MODULATION
+	Modulator_settings_t modulation;
+#endif
+} Logical_channel_t;
+
+/**
+ * Voice pool structure
+ */
+typedef struct {
+	Logical_channel_t channels[VOICE_LOGICAL_CHANNELS];
+	uint8_t owners[NUMBERS_OF_CHANNEL];   // Logical channel of each voice (VOICE_NONE if free)
+	uint8_t released[NUMBERS_OF_CHANNEL]; // 1 if the note of the voice is released (free at end of its envelope)
+	uint16_t stamps[NUMBERS_OF_CHANNEL];  // Note counter at the note on of each voice (age of the note)
+	uint16_t notes;                       // Note counter
+	uint8_t size;                         // Number of voices of the pool (1 to NUMBERS_OF_CHANNEL)
+	uint16_t steals;                      // Number of stolen voices
+} Voice_pool_t;
+
+/**
+ * Voice pool object
+ */
+extern volatile Voice_pool_t voice_pool;
+
+/**
+ * Number of voices rendered by the mixer
+ */
+#define MIXER_VOICES (voice_pool.size)
+
+/**
+ * Reset voice pool (every logical channel to mixer_reset() settings, every voice free, NUMBERS_OF_CHANNEL voices)
+ *
+ * @remarks Called by mixer_reset()
+ */
+void voice_reset(void);
+
+/**
+ * Set number of voices of the pool
+ *
+ * @param size Number of voices (clamped to 1 to NUMBERS_OF_CHANNEL)
+ * @remarks Notes of voices above the new size are cut
+ */
+void voice_set_pool_size(uint8_t size);
+
+/**
+ * Set waveform of specified logical channel
+ *
+ * @param channel Logical channel to set
+ * @param waveform Waveform to set
+ */
+void voice_set_wave(uint8_t channel, uint8_t waveform);
+
+/**
+ * Set volume of specified logical channel
+ *
+ * @param channel Logical channel to set
+ * @param volume Volume to set
+ */
+void voice_set_volume(uint8_t channel, uint8_t volume);
+
+/**
+ * Set position of specified logical channel on the output bus
+ *
+ * @param channel Logical channel to set
+ * @param pan Position to set (see mixer_set_pan())
+ */
+void voice_set_pan(uint8_t channel, uint8_t pan);
+
+/**
+ * Set ADSR envelope of specified logical channel
+ *
+ * @param channel Logical channel to set
+ * @param envelope Envelope to set
+ */
+void voice_set_adsr(uint8_t channel, uint8_t envelope);
+
+/**
+ * Set duty of specified logical channel
+ *
+ * @param channel Logical channel to set
+ * @param duty Duty value to set
+ */
+void voice_set_duty(uint8_t channel, uint8_t duty);
+
+#ifdef INSTRUMENT_BANK
+/**
+ * Apply an instrument to specified logical channel (see mixer_set_instrument())
+ *
+ * @param channel Logical channel to set
+ * @param instrument Instrument index
+ */
+void voice_set_instrument(uint8_t channel, uint8_t instrument);
+#endif
+
+#ifdef MODULATION
+/**
+ * Set base note of modulators of specified logical channel (see modulation_set_note())
+ *
+ * @param channel Logical channel to set
+ * @param note Note of note ON event
+ */
+void voice_set_note(uint8_t channel, uint8_t note);
+
+/**
+ * Set vibrato of specified logical channel (see modulation_set_vibrato())
+ *
+ * @param channel Logical channel to set
+ * @param depth Vibrato depth
+ * @param speed LFO phase increment per update
+ */
+void voice_set_vibrato(uint8_t channel, uint8_t depth, uint8_t speed);
+
+/**
+ * Set arpeggio of specified logical channel (see modulation_set_arpeggio())
+ *
+ * @param channel Logical channel to set
+ * @param semitones Offsets of second and third steps in semitones
+ * @param speed Number of updates per step
+ */
+void voice_set_arpeggio(uint8_t channel, uint8_t semitones, uint8_t speed);
+
+/**
+ * Set portamento of specified logical channel (see modulation_set_portamento())
+ *
+ * @param channel Logical channel to set
+ * @param speed Slide speed
+ */
+void voice_set_portamento(uint8_t channel, uint8_t speed);
+
+/**
+ * Set PWM of specified logical channel (see modulation_set_pwm())
+ *
+ * @param channel Logical channel to set
+ * @param depth PWM depth
+ * @param speed LFO phase increment per update
+ */
+void voice_set_pwm(uint8_t channel, uint8_t depth, uint8_t speed);
+
+/**
+ * Set volume slide of specified logical channel (see modulation_set_volume_slide())
+ *
+ * @param channel Logical channel to set
+ * @param slide Volume step per update
+ */
+void voice_set_volume_slide(uint8_t channel, int8_t slide);
+#endif
+
+/**
+ * Start note ON event on specified logical channel (allocate a voice if the channel has none)
+ *
+ * @param channel Logical channel to set
+ * @param frequency Frequency of note ON event
+ */
+void voice_note_on(uint8_t channel, uint8_t frequency);
+
+/**
+ * Start note OFF on specified logical channel (the voice is free at end of its envelope)
+ *
+ * @param channel Logical channel to set
+ */
+void voice_note_off(uint8_t channel);
+
+/**
+ * Sync two logical channels (no effect if one of them has no voice)
+ *
+ * @param channel_1 Logical channel to sync
+ * @param channel_2 Logical channel to sync with
+ */
+void voice_sync_oscillators(uint8_t channel_1, uint8_t channel_2);
+
+/**
+ * Reset oscillator of specified logical channel (no effect if it has no voice)
+ *
+ * @param channel Logical channel of oscillator to reset
+ */
+void voice_reset_oscillator(uint8_t channel);
+
+#else
+
+/**
+ * Number of voices rendered by the mixer
+ */
+#define MIXER_VOICES NUMBERS_OF_CHANNEL
+
+#endif
+
+#endif // _VOICE_H_